@@ -37,11 +37,39 @@
 // Does not allow operations when ranges have multiple different dimensions
 #include "cpp_range_multi.hpp"
 
+// Multi-dimensional Range with a fixed number of dimensions
+#include "cpp_range_fixed.hpp"
+
+// Flat one dimensional range set
+#include "cpp_range_set.hpp"
+
+// Strided one dimensional range
+#include "cpp_range_stride.hpp"
+
 // Complex multi-dimensional Range
 // Allow arbitrary different dimensions
+#include "cpp_range_bitmap.hpp"
 #include "cpp_range_map_base.hpp"
 #include "cpp_range_map.hpp"
 
+// Lazy iteration of the range vectors and points of a RangeMap
+#include "cpp_range_map_iterator.hpp"
+
+// Opt-in operation cache of RangeMap
+#include "cpp_range_map_cache.hpp"
+
+// Coordinate compression of a group of RangeMaps
+#include "cpp_range_map_compressor.hpp"
+
+// RangeMap stored in a permuted dimension order
+#include "cpp_range_map_view.hpp"
+
+// Read-only breadth-first snapshot of a RangeMap
+#include "cpp_range_map_snapshot.hpp"
+
+// RangeMap with a B+-tree top level for very wide maps
+#include "cpp_range_btree.hpp"
+
 // the utility function
 #include "cpp_range_util.hpp"
 
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * Dense bitmap of a fragmented one dimensional range list
+ * 18/10/2026
+ *
+ * Note: this class is not suppose to be used by user directly
+ *
+ */
+
+#ifndef _CPP_RANGE_BITMAP_H_
+#define _CPP_RANGE_BITMAP_H_
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <boost/foreach.hpp>
+#include <boost/cstdint.hpp>
+
+#include "cpp_range_element.hpp"
+
+// the widest domain (in values) a range list is turned into a bitmap for
+// define it as 0 to always operate on range lists
+#ifndef CPP_RANGE_BITMAP_SPAN
+#define CPP_RANGE_BITMAP_SPAN 65536
+#endif
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeBitmap
+  //
+  // one bit per value over a window [upper:lower] of an integral domain
+  // used by RangeMapBase to operate on lists of leaf ranges which are so
+  // fragmented that a word of the bitmap holds at least one range on average,
+  // where unions, intersections and complements become word-wide
+  // or / and / and-not operations
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeBitmap {
+  private:
+    T base;                                 // the value of bit 0
+    std::vector<boost::uint64_t> bits;      // 64 values per word, from the lowest value
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeBitmap();
+    RangeBitmap(const T&, const T&);                    // an empty bitmap covering [rh:rl]
+    template<class InputIterator>
+    RangeBitmap(const T&, const T&, InputIterator first, InputIterator last);
+                                                        // set a list of ranges inside [rh:rl]
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    static bool fit(const T&, const T&, std::size_t);   // ? a window holding a number of
+                                                        // ranges is worth a bitmap
+    T size() const;                                     // the number of values set
+    bool empty() const;                                 // ? no value is set
+    bool test(const T&) const;                          // ? a value is set
+    void set(const RangeElement<T>&);                   // set all values of a range
+    bool subset(const RangeBitmap&) const;              // ? this is a subset of r
+    RangeBitmap& combine(const RangeBitmap&);           // this |= r
+    RangeBitmap& intersection(const RangeBitmap&);      // this &= r
+    RangeBitmap& complement(const RangeBitmap&);        // this &= ~r
+    template<class R>
+    void toList(std::vector<R>&) const;                 // append the maximal runs from
+                                                        // high to low
+
+    //////////////////////////////////////////////
+    // word level helpers on a raw bit array
+
+    static void set(boost::uint64_t*, std::size_t, std::size_t);
+                                                        // set the bits [lo, hi]
+    static std::size_t next(const boost::uint64_t*, std::size_t, bool, std::size_t);
+                                                        // the next bit of a value
+    static std::size_t runs(const boost::uint64_t*, std::size_t, std::size_t);
+                                                        // the number of runs of the bits
+                                                        // [from, to)
+    template<class R>
+    static void toList(const boost::uint64_t*, std::size_t, std::size_t, const T&,
+                       std::vector<R>&);                // append the runs of the bits
+                                                        // [from, to) from high to low
+
+  private:
+    static unsigned int lowest_bit(boost::uint64_t);    // the index of the lowest set bit
+    static unsigned int popcount(boost::uint64_t);      // the number of set bits
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+  template<class T> inline
+  RangeBitmap<T>::RangeBitmap()
+    : base(0) {}
+
+  template<class T> inline
+  RangeBitmap<T>::RangeBitmap(const T& rh, const T& rl)
+    : base(rl),
+      bits(static_cast<std::size_t>((static_cast<boost::uintmax_t>(rh) -
+                                     static_cast<boost::uintmax_t>(rl)) / 64 + 1), 0) {}
+
+  template<class T> template<class InputIterator> inline
+  RangeBitmap<T>::RangeBitmap(const T& rh, const T& rl, InputIterator first, InputIterator last)
+    : base(rl),
+      bits(static_cast<std::size_t>((static_cast<boost::uintmax_t>(rh) -
+                                     static_cast<boost::uintmax_t>(rl)) / 64 + 1), 0) {
+    for(; first != last; ++first) set(*first);
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  // a bitmap costs a word every 64 values and a range list a node per range,
+  // only integral domains narrower than CPP_RANGE_BITMAP_SPAN are considered
+  // the span is computed in unsigned arithmetic so a wide window never overflows,
+  // an unbounded type is checked in its own arithmetic first
+  template<class T> inline
+  bool RangeBitmap<T>::fit(const T& rh, const T& rl, std::size_t n) {
+    if(!std::numeric_limits<T>::is_integer || rh < rl) return false;
+    if(!std::numeric_limits<T>::is_bounded && !(rh - rl < T(CPP_RANGE_BITMAP_SPAN))) return false;
+    boost::uintmax_t span =
+      static_cast<boost::uintmax_t>(rh) - static_cast<boost::uintmax_t>(rl);
+    return span < CPP_RANGE_BITMAP_SPAN && span / 64 < n;
+  }
+
+  template<class T> inline
+  T RangeBitmap<T>::size() const {
+    T rv(0);
+    BOOST_FOREACH(boost::uint64_t w, bits)
+      rv = size_add(rv, T(popcount(w)));
+    return rv;
+  }
+
+  template<class T> inline
+  bool RangeBitmap<T>::empty() const {
+    BOOST_FOREACH(boost::uint64_t w, bits)
+      if(w) return false;
+    return true;
+  }
+
+  template<class T> inline
+  bool RangeBitmap<T>::test(const T& v) const {
+    if(v < base) return false;
+    boost::uintmax_t i = static_cast<boost::uintmax_t>(v) - static_cast<boost::uintmax_t>(base);
+    if(i / 64 >= bits.size()) return false;
+    return (bits[i / 64] >> (i % 64)) & 1;
+  }
+
+  // the range must be inside the window
+  template<class T> inline
+  void RangeBitmap<T>::set(const RangeElement<T>& r) {
+    set(&bits[0],
+        static_cast<boost::uintmax_t>(r.lower()) - static_cast<boost::uintmax_t>(base),
+        static_cast<boost::uintmax_t>(r.upper()) - static_cast<boost::uintmax_t>(base));
+  }
+
+  // both bitmaps must cover the same window
+  template<class T> inline
+  bool RangeBitmap<T>::subset(const RangeBitmap& r) const {
+    for(std::size_t i = 0; i < bits.size(); i++)
+      if(bits[i] & ~r.bits[i]) return false;
+    return true;
+  }
+
+  template<class T> inline
+  RangeBitmap<T>& RangeBitmap<T>::combine(const RangeBitmap& r) {
+    for(std::size_t i = 0; i < bits.size(); i++) bits[i] |= r.bits[i];
+    return *this;
+  }
+
+  template<class T> inline
+  RangeBitmap<T>& RangeBitmap<T>::intersection(const RangeBitmap& r) {
+    for(std::size_t i = 0; i < bits.size(); i++) bits[i] &= r.bits[i];
+    return *this;
+  }
+
+  template<class T> inline
+  RangeBitmap<T>& RangeBitmap<T>::complement(const RangeBitmap& r) {
+    for(std::size_t i = 0; i < bits.size(); i++) bits[i] &= ~r.bits[i];
+    return *this;
+  }
+
+  template<class T> template<class R> inline
+  void RangeBitmap<T>::toList(std::vector<R>& rv) const {
+    if(!bits.empty()) toList(&bits[0], 0, bits.size() * 64, base, rv);
+  }
+
+  //////////////////////////////////////////////
+  // word level helpers
+
+  // the words between the two ends are filled at once
+  template<class T> inline
+  void RangeBitmap<T>::set(boost::uint64_t* w, std::size_t lo, std::size_t hi) {
+    const boost::uint64_t full = ~boost::uint64_t(0);
+    boost::uint64_t lmask = full << (lo % 64);
+    boost::uint64_t hmask = full >> (63 - hi % 64);
+    if(lo / 64 == hi / 64) {
+      w[lo / 64] |= lmask & hmask;
+    } else {
+      w[lo / 64] |= lmask;
+      std::fill(w + lo / 64 + 1, w + hi / 64, full);
+      w[hi / 64] |= hmask;
+    }
+  }
+
+  // the index of the first bit equal to 'value' from bit 'from' in the first n bits,
+  // n if none, the bits after n in the last word are ignored
+  template<class T> inline
+  std::size_t RangeBitmap<T>::next(const boost::uint64_t* w, std::size_t n,
+                                   bool value, std::size_t from) {
+    if(from >= n) return n;
+    std::size_t i = from / 64, last = (n - 1) / 64;
+    boost::uint64_t v = (value ? w[i] : ~w[i]) & (~boost::uint64_t(0) << (from % 64));
+    while(!v) {
+      if(i == last) return n;
+      ++i;
+      v = value ? w[i] : ~w[i];
+    }
+    return std::min(i * 64 + lowest_bit(v), n);
+  }
+
+  // a run starts at every set bit whose lower neighbour is clear
+  template<class T> inline
+  std::size_t RangeBitmap<T>::runs(const boost::uint64_t* w, std::size_t from, std::size_t to) {
+    if(from >= to) return 0;
+    const boost::uint64_t full = ~boost::uint64_t(0);
+    std::size_t rv = 0, first = from / 64, last = (to - 1) / 64;
+    boost::uint64_t carry = 0;
+    for(std::size_t i = first; i <= last; i++) {
+      boost::uint64_t v = w[i];
+      if(i == first) v &= full << (from % 64);
+      if(i == last)  v &= full >> (63 - (to - 1) % 64);
+      rv += popcount(v & ~((v << 1) | carry));
+      carry = v >> 63;
+    }
+    return rv;
+  }
+
+  // runs are found from the lowest bit and appended in the order of a range list,
+  // bit 'from' holds the value 'lower'
+  template<class T> template<class R> inline
+  void RangeBitmap<T>::toList(const boost::uint64_t* w, std::size_t from, std::size_t to,
+                              const T& lower, std::vector<R>& rv) {
+    std::size_t first = rv.size();
+    rv.reserve(first + runs(w, from, to));
+    for(std::size_t lo = next(w, to, true, from); lo < to; ) {
+      std::size_t hi = next(w, to, false, lo);
+      rv.push_back(R(T(lower + T(hi - 1 - from)), T(lower + T(lo - from))));
+      lo = next(w, to, true, hi);
+    }
+    std::reverse(rv.begin() + first, rv.end());
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  // de Bruijn multiplication on the isolated lowest bit
+  template<class T> inline
+  unsigned int RangeBitmap<T>::lowest_bit(boost::uint64_t w) {
+    static const unsigned int table[64] = {
+      0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+      62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+      63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+      46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+    };
+    return table[((w & (~w + 1)) * 0x03f79d71b4cb0a89ULL) >> 58];
+  }
+
+  template<class T> inline
+  unsigned int RangeBitmap<T>::popcount(boost::uint64_t w) {
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (w * 0x0101010101010101ULL) >> 56;
+  }
+
+}
+
+#endif
@@ -0,0 +1,587 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * RangeMap with a B+-tree top level
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_BTREE_H_
+#define _CPP_RANGE_BTREE_H_
+
+#include <list>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <boost/foreach.hpp>
+
+#include "cpp_range_map.hpp"
+
+// the maximal number of ranges or children in a B+-tree node
+#ifndef CPP_RANGE_BTREE_ORDER
+#define CPP_RANGE_BTREE_ORDER 64
+#endif
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeBTree
+  //
+  // a RangeMap whose top level is stored in a B+-tree keyed by the
+  // range bounds, used for very wide top levels
+  // inserting, removing and looking up a range vector cost O(log n)
+  // in the number of top-level ranges, while the lower dimensions are
+  // stored in normal RangeMapBase child lists
+  // leaves are linked, so converting to and from a RangeMap is a
+  // sequential O(n) operation
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeBTree {
+  private:
+    struct Node {
+      bool leaf;
+      std::vector<RangeMapBase<T> > entry;  // leaf: top-level ranges, higher first
+      std::vector<Node*> kid;               // internal: child nodes, higher first
+      std::vector<T> key;                   // internal: the lowest bound in each child
+      Node* next;                           // leaf: the next (lower) leaf
+
+      explicit Node(bool l) : leaf(l), next(NULL) {}
+      unsigned int width() const { return leaf ? entry.size() : kid.size(); }
+      const T& lowest() const { return leaf ? entry.back().lower() : key.back(); }
+    };
+
+    // position of a top-level range
+    struct Cursor {
+      Node* node;
+      unsigned int index;
+    };
+
+    Node* root;                             // root node, NULL when empty
+    unsigned int count;                     // the number of top-level ranges
+    unsigned int level;                     // level of sub-ranges
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeBTree();
+    explicit RangeBTree(const RangeMap<T>&);            // bulk load a RangeMap
+    RangeBTree(const RangeBTree&);
+    RangeBTree& operator= (const RangeBTree&);
+    ~RangeBTree();
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    unsigned int dimension() const;                     // the number of dimensions
+    unsigned int width() const;                         // the number of top-level ranges
+    T size() const;                                     // the size of the range
+    bool empty() const;                                 // ? this is an empty range
+    bool contains(const std::vector<T>&) const;         // ? a point belongs to this range
+    void insert(const Range<T>&);                       // add a range vector
+    void remove(const Range<T>&);                       // subtract a range vector
+    RangeBTree combine(const RangeBTree& r) const;      // get the union of this and r
+    RangeBTree intersection(const RangeBTree& r) const; // get the intersection of this and r
+    RangeBTree complement(const RangeBTree& r) const;   // subtract r from this range
+    RangeMap<T> toRangeMap() const;                     // convert to a RangeMap
+    std::string toString(bool compress = true) const;   // simple conversion to string
+
+  private:
+    void clear();                                       // delete all nodes
+    void load(const std::vector<RangeMapBase<T> >&);      // bulk load sorted ranges
+    std::vector<RangeMapBase<T> > toList() const;         // get all top-level ranges
+    Cursor find(const T&) const;                        // the first range whose lower
+                                                        // bound is not larger than a value
+    void advance(Cursor&) const;                        // move to the next (lower) range
+    std::vector<RangeMapBase<T> > extract(const RangeElement<T>&);
+                                                        // remove and return the ranges
+                                                        // overlapped or connected with a range
+    void insert_node(const RangeMapBase<T>&);           // insert a disjoint top-level range
+    void erase_node(const T&);                          // erase a top-level range by its
+                                                        // lower bound
+    void check(const Range<T>&, const std::string&);    // check the range to be inserted
+                                                        // or removed
+
+    //////////////////////////////////
+    // static helper functions
+
+    static unsigned int child_index(const Node*, const T&);
+                                                        // the child to hold a lower bound
+    static unsigned int entry_index(const Node*, const T&);
+                                                        // the first range in a leaf whose
+                                                        // lower bound is not larger than
+                                                        // a value
+    static Node* insert(Node*, const RangeMapBase<T>&); // insert a range into a sub-tree,
+                                                        // return the new sibling if split
+    static bool erase(Node*, const T&);                 // erase a range from a sub-tree,
+                                                        // return true if underflow
+    static Node* split(Node*);                          // split a full node
+    static void rebalance(Node*, unsigned int);         // fix an underflow child
+    static void destroy(Node*);                         // delete a sub-tree
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+
+  template<class T> inline
+  RangeBTree<T>::RangeBTree()
+    : root(NULL), count(0), level(0) {}
+
+  template<class T> inline
+  RangeBTree<T>::RangeBTree(const RangeMap<T>& r)
+    : root(NULL), count(0), level(0) {
+    if(r.empty()) return;
+    load(r.child);
+    level = r.dimension();
+  }
+
+  template<class T> inline
+  RangeBTree<T>::RangeBTree(const RangeBTree& r)
+    : root(NULL), count(0), level(r.level) {
+    load(r.toList());
+  }
+
+  template<class T> inline
+  RangeBTree<T>& RangeBTree<T>::operator= (const RangeBTree& r) {
+    if(this != &r) {
+      clear();
+      load(r.toList());
+      level = r.level;
+    }
+    return *this;
+  }
+
+  template<class T> inline
+  RangeBTree<T>::~RangeBTree() {
+    clear();
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  // get the number of dimensions
+  template<class T> inline
+  unsigned int RangeBTree<T>::dimension() const {
+    return level;
+  }
+
+  // get the number of top-level ranges
+  template<class T> inline
+  unsigned int RangeBTree<T>::width() const {
+    return count;
+  }
+
+  // get the bit size of this range
+  // saturated as RangeMap::size()
+  template<class T> inline
+  T RangeBTree<T>::size() const {
+    T rv(0);
+    Node* n = root;
+    while(n && !n->leaf) n = n->kid.front();
+    for(; n; n = n->next)
+      BOOST_FOREACH(const RangeMapBase<T>& b, n->entry)
+        rv = size_add(rv, b.size());
+    return rv;
+  }
+
+  // whether the range is empty
+  template<class T> inline
+  bool RangeBTree<T>::empty() const {
+    return count == 0;
+  }
+
+  // check whether a point belongs to this range
+  template<class T> inline
+  bool RangeBTree<T>::contains(const std::vector<T>& point) const {
+    if(empty()) return false;
+    if(point.size() != level) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), point_string(point), "contains()"));
+#endif
+      return false;
+    }
+    Cursor c = find(point.front());
+    if(!c.node) return false;
+    const RangeMapBase<T>* b = &(c.node->entry[c.index]);
+    if(b->upper() < point.front()) return false;
+    for(unsigned int i=1; i<level; i++) {  // lower dimensions are normal child lists
+      b = RangeMapBase<T>::find(b->child, point[i]);
+      if(!b) return false;
+    }
+    return true;
+  }
+
+  // add a range vector
+  template<class T> inline
+  void RangeBTree<T>::insert(const Range<T>& r) {
+    check(r, "insert()");
+    if(r.empty()) return;
+
+    RangeMapBase<T> mr(r);
+    std::vector<RangeMapBase<T> > rlist = extract(mr);
+    RangeMapBase<T>::add_child(rlist, mr);
+    BOOST_FOREACH(const RangeMapBase<T>& b, rlist)
+      insert_node(b);
+    level = r.dimension();
+  }
+
+  // subtract a range vector
+  template<class T> inline
+  void RangeBTree<T>::remove(const Range<T>& r) {
+    check(r, "remove()");
+    if(r.empty() || empty()) return;
+
+    std::vector<RangeMapBase<T> > rhs(1, RangeMapBase<T>(r));
+    std::vector<RangeMapBase<T> > rlist =
+      RangeMapBase<T>::complement(extract(rhs.front()), rhs);
+    BOOST_FOREACH(const RangeMapBase<T>& b, rlist)
+      insert_node(b);
+  }
+
+  // combine two ranges by a sequential merge
+  template<class T> inline
+  RangeBTree<T> RangeBTree<T>::combine(const RangeBTree& r) const {
+    return RangeBTree(toRangeMap().combine(r.toRangeMap()));
+  }
+
+  // get the shared range of two ranges by a sequential merge
+  template<class T> inline
+  RangeBTree<T> RangeBTree<T>::intersection(const RangeBTree& r) const {
+    return RangeBTree(toRangeMap().intersection(r.toRangeMap()));
+  }
+
+  // this deducted by r by a sequential merge
+  template<class T> inline
+  RangeBTree<T> RangeBTree<T>::complement(const RangeBTree& r) const {
+    return RangeBTree(toRangeMap().complement(r.toRangeMap()));
+  }
+
+  // convert to a RangeMap
+  template<class T> inline
+  RangeMap<T> RangeBTree<T>::toRangeMap() const {
+    return RangeMap<T>(toList());
+  }
+
+  // convert to string
+  template<class T> inline
+  std::string RangeBTree<T>::toString(bool compress) const {
+    return toRangeMap().toString(compress);
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  template<class T> inline
+  void RangeBTree<T>::clear() {
+    destroy(root);
+    root = NULL;
+    count = 0;
+  }
+
+  // bulk load a sorted list of disjoint ranges
+  // fill the nodes evenly so that every node is at least half full
+  template<class T> inline
+  void RangeBTree<T>::load(const std::vector<RangeMapBase<T> >& rlist) {
+    clear();
+    if(rlist.empty()) return;
+
+    std::vector<Node*> layer;
+    unsigned int n = rlist.size();
+    unsigned int nnode = (n + CPP_RANGE_BTREE_ORDER - 1) / CPP_RANGE_BTREE_ORDER;
+    typename std::vector<RangeMapBase<T> >::const_iterator it = rlist.begin();
+    for(unsigned int i=0; i<nnode; i++) {
+      Node* leaf = new Node(true);
+      unsigned int w = n / nnode + (i < n % nnode ? 1 : 0);
+      for(unsigned int j=0; j<w; j++)
+        leaf->entry.push_back(*it++);
+      if(!layer.empty()) layer.back()->next = leaf;
+      layer.push_back(leaf);
+    }
+    count = n;
+
+    while(layer.size() > 1) {
+      std::vector<Node*> upper;
+      n = layer.size();
+      nnode = (n + CPP_RANGE_BTREE_ORDER - 1) / CPP_RANGE_BTREE_ORDER;
+      unsigned int k = 0;
+      for(unsigned int i=0; i<nnode; i++) {
+        Node* node = new Node(false);
+        unsigned int w = n / nnode + (i < n % nnode ? 1 : 0);
+        for(unsigned int j=0; j<w; j++, k++) {
+          node->kid.push_back(layer[k]);
+          node->key.push_back(layer[k]->lowest());
+        }
+        upper.push_back(node);
+      }
+      layer.swap(upper);
+    }
+    root = layer.front();
+  }
+
+  // collect all top-level ranges in order
+  template<class T> inline
+  std::vector<RangeMapBase<T> > RangeBTree<T>::toList() const {
+    std::vector<RangeMapBase<T> > rv;
+    Node* n = root;
+    while(n && !n->leaf) n = n->kid.front();
+    for(; n; n = n->next)
+      rv.insert(rv.end(), n->entry.begin(), n->entry.end());
+    RangeMapBase<T>::accumulate(rv);
+    return rv;
+  }
+
+  // find the first range whose lower bound is not larger than v
+  // ranges are stored from high to low, so it is the only range which may hold v
+  template<class T> inline
+  typename RangeBTree<T>::Cursor RangeBTree<T>::find(const T& v) const {
+    Cursor rv;
+    rv.node = NULL;
+    rv.index = 0;
+    if(!root || root->lowest() > v) return rv;
+
+    Node* n = root;
+    while(!n->leaf) n = n->kid[child_index(n, v)];
+    rv.node = n;
+    rv.index = entry_index(n, v);
+    return rv;
+  }
+
+  template<class T> inline
+  void RangeBTree<T>::advance(Cursor& c) const {
+    if(++c.index == c.node->entry.size()) {
+      c.node = c.node->next;
+      c.index = 0;
+    }
+  }
+
+  // remove the ranges overlapped or connected with r
+  // ranges in the returned list are in order
+  // no bound is stepped past the largest value
+  template<class T> inline
+  std::vector<RangeMapBase<T> > RangeBTree<T>::extract(const RangeElement<T>& r) {
+    std::vector<RangeMapBase<T> > rv;
+    for(Cursor c = find(is_largest(r.upper()) ? r.upper() : r.upper() + min_unit<T>());
+        c.node && !separated(c.node->entry[c.index].upper(), r.lower());
+        advance(c))
+      rv.push_back(c.node->entry[c.index]);
+    BOOST_FOREACH(const RangeMapBase<T>& b, rv)
+      erase_node(b.lower());
+    return rv;
+  }
+
+  template<class T> inline
+  void RangeBTree<T>::insert_node(const RangeMapBase<T>& r) {
+    if(!root) root = new Node(true);
+    Node* s = insert(root, r);
+    if(s) {                     // grow the tree
+      Node* n = new Node(false);
+      n->kid.push_back(root);
+      n->key.push_back(root->lowest());
+      n->kid.push_back(s);
+      n->key.push_back(s->lowest());
+      root = n;
+    }
+    ++count;
+  }
+
+  template<class T> inline
+  void RangeBTree<T>::erase_node(const T& v) {
+    erase(root, v);
+    --count;
+    while(!root->leaf && root->width() == 1) {
+      Node* n = root;           // shrink the tree
+      root = n->kid.front();
+      n->kid.clear();
+      delete n;
+    }
+    if(root->width() == 0) {    // empty tree
+      delete root;
+      root = NULL;
+    }
+  }
+
+  template<class T> inline
+  void RangeBTree<T>::check(const Range<T>& r, const std::string& op) {
+    if(!r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+    }
+    if(!r.empty() && !empty() && r.dimension() != level) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), r.toString(), op));
+#endif
+    }
+  }
+
+  //////////////////////////////////
+  // static helper functions
+
+  // children are ordered from high to low,
+  // so choose the first child whose lowest bound is not larger than v
+  template<class T> inline
+  unsigned int RangeBTree<T>::child_index(const Node* n, const T& v) {
+    unsigned int rv =
+      std::lower_bound(n->key.begin(), n->key.end(), v, std::greater<T>()) - n->key.begin();
+    return rv == n->key.size() ? rv - 1 : rv;
+  }
+
+  template<class T> inline
+  unsigned int RangeBTree<T>::entry_index(const Node* n, const T& v) {
+    unsigned int first = 0, last = n->entry.size();
+    while(first < last) {
+      unsigned int mid = (first + last) / 2;
+      if(n->entry[mid].lower() > v) first = mid + 1;
+      else                          last = mid;
+    }
+    return first;
+  }
+
+  template<class T> inline
+  typename RangeBTree<T>::Node* RangeBTree<T>::insert(Node* n, const RangeMapBase<T>& r) {
+    if(n->leaf) {
+      n->entry.insert(n->entry.begin() + entry_index(n, r.lower()), r);
+    } else {
+      unsigned int k = child_index(n, r.lower());
+      Node* s = insert(n->kid[k], r);
+      n->key[k] = n->kid[k]->lowest();
+      if(s) {
+        n->kid.insert(n->kid.begin() + k + 1, s);
+        n->key.insert(n->key.begin() + k + 1, s->lowest());
+      }
+    }
+    if(n->width() > CPP_RANGE_BTREE_ORDER) return split(n);
+    else                                  return NULL;
+  }
+
+  template<class T> inline
+  bool RangeBTree<T>::erase(Node* n, const T& v) {
+    if(n->leaf) {
+      n->entry.erase(n->entry.begin() + entry_index(n, v));
+    } else {
+      unsigned int k = child_index(n, v);
+      if(erase(n->kid[k], v))
+        rebalance(n, k);
+      else
+        n->key[k] = n->kid[k]->lowest();
+    }
+    return n->width() < CPP_RANGE_BTREE_ORDER / 2;
+  }
+
+  // move the lower half of a node to a new sibling
+  template<class T> inline
+  typename RangeBTree<T>::Node* RangeBTree<T>::split(Node* n) {
+    Node* s = new Node(n->leaf);
+    unsigned int half = n->width() / 2;
+    if(n->leaf) {
+      s->entry.assign(n->entry.begin() + half, n->entry.end());
+      n->entry.erase(n->entry.begin() + half, n->entry.end());
+      s->next = n->next;
+      n->next = s;
+    } else {
+      s->kid.assign(n->kid.begin() + half, n->kid.end());
+      s->key.assign(n->key.begin() + half, n->key.end());
+      n->kid.erase(n->kid.begin() + half, n->kid.end());
+      n->key.erase(n->key.begin() + half, n->key.end());
+    }
+    return s;
+  }
+
+  // borrow from or merge with a sibling of the underflow child n->kid[k]
+  template<class T> inline
+  void RangeBTree<T>::rebalance(Node* n, unsigned int k) {
+    if(n->kid.size() == 1) {    // no sibling, only happens at the root
+      if(n->kid[k]->width()) n->key[k] = n->kid[k]->lowest();
+      return;
+    }
+
+    // always work on a pair of adjacent children: l = kid[i], r = kid[i+1]
+    unsigned int i = (k + 1 < n->kid.size()) ? k : k - 1;
+    Node* l = n->kid[i];
+    Node* r = n->kid[i+1];
+
+    if(l->width() + r->width() <= CPP_RANGE_BTREE_ORDER) {
+      // merge r into l
+      if(l->leaf) {
+        l->entry.insert(l->entry.end(), r->entry.begin(), r->entry.end());
+        l->next = r->next;
+      } else {
+        l->kid.insert(l->kid.end(), r->kid.begin(), r->kid.end());
+        l->key.insert(l->key.end(), r->key.begin(), r->key.end());
+        r->kid.clear();
+      }
+      delete r;
+      n->kid.erase(n->kid.begin() + i + 1);
+      n->key.erase(n->key.begin() + i + 1);
+      n->key[i] = l->lowest();
+      return;
+    } else if(l->width() < r->width()) {
+      // move the highest item of r to l
+      if(l->leaf) {
+        l->entry.push_back(r->entry.front());
+        r->entry.erase(r->entry.begin());
+      } else {
+        l->kid.push_back(r->kid.front());
+        l->key.push_back(r->key.front());
+        r->kid.erase(r->kid.begin());
+        r->key.erase(r->key.begin());
+      }
+    } else {
+      // move the lowest item of l to r
+      if(l->leaf) {
+        r->entry.insert(r->entry.begin(), l->entry.back());
+        l->entry.pop_back();
+      } else {
+        r->kid.insert(r->kid.begin(), l->kid.back());
+        r->key.insert(r->key.begin(), l->key.back());
+        l->kid.pop_back();
+        l->key.pop_back();
+      }
+    }
+    n->key[i] = l->lowest();
+    n->key[i+1] = r->lowest();
+  }
+
+  template<class T> inline
+  void RangeBTree<T>::destroy(Node* n) {
+    if(!n) return;
+    BOOST_FOREACH(Node* c, n->kid)
+      destroy(c);
+    delete n;
+  }
+
+  /////////////////////////////////////////////
+  // overload operators
+
+  // standard out stream
+  template<class T>
+  std::ostream& operator<< (std::ostream& os, const RangeBTree<T>& r) {
+    os << r.toString();
+    return os;
+  }
+
+}
+
+#endif
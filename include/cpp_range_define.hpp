@@ -29,6 +29,7 @@
 
 #include <exception>
 #include <string>
+#include <limits>
 
 namespace CppRange {
 
@@ -53,6 +54,120 @@ namespace CppRange {
     return 0.0;
   }
 
+  // the bound pair [empty_upper():empty_lower()] marks an empty range
+  // (a range constructed without value)
+  // it is an illegal range expression so no legal range is lost, and the same
+  // pair given as bounds is stored as [empty_upper():invalid_lower()] so it
+  // stays an invalid range
+  template<class T>
+  T empty_upper() {
+    return std::numeric_limits<T>::is_bounded ? std::numeric_limits<T>::min() : T(0);
+  }
+
+  template<class T>
+  T empty_lower() {
+    return std::numeric_limits<T>::is_bounded ? std::numeric_limits<T>::max() : T(1);
+  }
+
+  // specializations
+  template<>
+  inline double empty_upper<double>() {
+    return -std::numeric_limits<double>::max();
+  }
+
+  template<>
+  inline double empty_lower<double>() {
+    return std::numeric_limits<double>::max();
+  }
+
+  template<>
+  inline float empty_upper<float>() {
+    return -std::numeric_limits<float>::max();
+  }
+
+  template<>
+  inline float empty_lower<float>() {
+    return std::numeric_limits<float>::max();
+  }
+
+  // a lower bound above empty_upper() other than empty_lower()
+  template<class T>
+  T invalid_lower() {
+    return std::numeric_limits<T>::is_bounded ? std::numeric_limits<T>::max() - 1 : T(2);
+  }
+
+  template<>
+  inline double invalid_lower<double>() {
+    return 0.0;
+  }
+
+  template<>
+  inline float invalid_lower<float>() {
+    return 0.0;
+  }
+
+  // the bound pair [full_upper():full_lower()] is the whole domain of a type
+  // a range of it is a wildcard, "all of this dimension", printed as [*]
+  // only bounded types have a wildcard
+  template<class T>
+  T full_upper() {
+    return empty_lower<T>();
+  }
+
+  template<class T>
+  T full_lower() {
+    return empty_upper<T>();
+  }
+
+  // ? a gap lies between a range ending at upper and a higher range starting
+  // at lower (upper + 1 < lower), upper is only stepped when it is below lower
+  // so it never passes the largest value of the type
+  template<class T>
+  bool separated(const T& upper, const T& lower) {
+    return upper < lower && upper + min_unit<T>() < lower;
+  }
+
+  // ? the largest value of a bounded type, which has no value above it
+  template<class T>
+  bool is_largest(const T& v) {
+    return std::numeric_limits<T>::is_bounded && v == std::numeric_limits<T>::max();
+  }
+
+  // saturated size arithmetic
+  // the size of a bounded integral type stops at its largest value instead
+  // of overflowing, other types (floating points or wide integers) are exact
+  template<class T>
+  bool size_saturated() {
+    return std::numeric_limits<T>::is_bounded && std::numeric_limits<T>::is_integer;
+  }
+
+  // the size of [upper:lower], upper is not below lower
+  template<class T>
+  T size_span(const T& upper, const T& lower) {
+    if(size_saturated<T>()) {
+      const T top = std::numeric_limits<T>::max();
+      if(lower < T(0) && top + lower < upper) return top;
+      if(upper - lower == top) return top;
+    }
+    return upper - lower + min_unit<T>();
+  }
+
+  // the sum of two sizes
+  template<class T>
+  T size_add(const T& a, const T& b) {
+    if(size_saturated<T>() && std::numeric_limits<T>::max() - a < b)
+      return std::numeric_limits<T>::max();
+    return a + b;
+  }
+
+  // the product of two sizes
+  template<class T>
+  T size_mul(const T& a, const T& b) {
+    if(size_saturated<T>() && T(0) < a && std::numeric_limits<T>::max() / a < b)
+      return std::numeric_limits<T>::max();
+    return a * b;
+  }
+
   // error exceptions
 
   // To disable exception and return empty ranges silently, discomment the following MACRO
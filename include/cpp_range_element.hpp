@@ -49,8 +49,9 @@ namespace CppRange {
   template <class T>
   class RangeElement {
   private:
-    bool initialized;           // false if constructed without range value
     std::pair<T, T> r_pair;     // specific range expression
+                                // [empty_upper():empty_lower()] if constructed
+                                // without range value
 
   public:
     //////////////////////////////////////////////
@@ -73,6 +74,8 @@ namespace CppRange {
     T size() const;                                     // get the size of the range
     bool valid() const;                                 // check the range is valid
     bool empty() const;                                 // ? this is empty
+    bool full() const;                                  // ? this is the whole domain
+                                                        // (a wildcard)
     bool in(T num) const;                               // ? num belongs to this range
     bool subset(const RangeElement& r) const;           // ? this is a subset of r
     bool proper_subset(const RangeElement& r) const;    // ? this is a proper subset of r
@@ -95,6 +98,10 @@ namespace CppRange {
     divide(const RangeElement& r) const;                // standard divide/partition this and r
     
     std::string toString(bool compress = true) const;   // simple conversion to string 
+
+  private:
+    bool unset() const;                                 // ? constructed without range value
+    void keep_invalid();                                // move given bounds off the empty marker
   };
 
 }
@@ -111,17 +118,19 @@ namespace CppRange {
   // default
   template<class T> inline
   RangeElement<T>::RangeElement()
-    : initialized(false), r_pair(T(0), T(0)) {}
+    : r_pair(empty_upper<T>(), empty_lower<T>()) {}
 
   // single bit range
   template<class T> inline
   RangeElement<T>::RangeElement(const T& r)
-    : initialized(true), r_pair(r, r) {}
+    : r_pair(r, r) {}
 
   // bit range
   template<class T> inline
   RangeElement<T>::RangeElement(const T& rh, const T& rl)
-    : initialized(true), r_pair(rh, rl) {}
+    : r_pair(rh, rl) {
+    keep_invalid();
+  }
 
   // parse a range text
   template<class T> inline
@@ -134,8 +143,9 @@ namespace CppRange {
   // bound accessor
   template<class T> inline
   void RangeElement<T>::upper(const T& upper_bound) {
-    initialized = true; 
+    if(unset()) r_pair.second = T(0);
     r_pair.first = upper_bound;
+    keep_invalid();
   }
   
   template<class T> inline
@@ -145,8 +155,9 @@ namespace CppRange {
   
   template<class T> inline
   void RangeElement<T>::lower(const T& lower_bound) { 
-    initialized = true; 
+    if(unset()) r_pair.first = T(0);
     r_pair.second = lower_bound;
+    keep_invalid();
   }
   
   template<class T> inline
@@ -157,14 +168,14 @@ namespace CppRange {
   // get the size of the range
   template<class T> inline
   T RangeElement<T>::size() const {
-    if(!valid() || !initialized) return T(0);
-    return r_pair.first - r_pair.second + min_unit<T>();
+    if(upper() < lower()) return T(0); // invalid or unset
+    return size_span(upper(), lower());
   }
 
   // check the range has a valid expression
   template<class T> inline
   bool RangeElement<T>::valid() const {
-    return !(upper() < lower());
+    return !(upper() < lower()) || unset();
   }
     
   // check whether the range is empty
@@ -173,6 +184,12 @@ namespace CppRange {
     return size() == T(0);
   }
 
+  template<class T> inline
+  bool RangeElement<T>::full() const {
+    return std::numeric_limits<T>::is_bounded &&
+      upper() == full_upper<T>() && lower() == full_lower<T>();
+  }
+
   // check whether a number is in this range
   template<class T> inline
   bool RangeElement<T>::in(T num) const {
@@ -255,9 +272,10 @@ namespace CppRange {
       return false;
     }
     if(empty() || r.empty()) return false;
+    // a bound is only moved when it is below the other range, so never overflows
     return 
-      (!(upper() + min_unit<T>() < r.lower()) 
-       && !(r.upper() + min_unit<T>() < lower()));
+      (!(upper() < r.lower() && upper() + min_unit<T>() < r.lower())
+       && !(r.upper() < lower() && r.upper() + min_unit<T>() < lower()));
   }
 
   // weak order
@@ -405,10 +423,14 @@ namespace CppRange {
         boost::get<0>(rv) = *this;          
       }
     } else {
+      // the outer parts are only computed when they exist, as the shared part
+      // may reach the limits of the domain
       RangeElement ROr = hull(r);
-      boost::get<0>(rv) = RangeElement(ROr.upper(), RAnd.upper() +  min_unit<T>());
+      if(RAnd.upper() < ROr.upper())
+        boost::get<0>(rv) = RangeElement(ROr.upper(), RAnd.upper() +  min_unit<T>());
       boost::get<1>(rv) = RAnd;
-      boost::get<2>(rv) = RangeElement(RAnd.lower() -  min_unit<T>(), ROr.lower());
+      if(ROr.lower() < RAnd.lower())
+        boost::get<2>(rv) = RangeElement(RAnd.lower() -  min_unit<T>(), ROr.lower());
     }
     return rv;
   }
@@ -417,6 +439,7 @@ namespace CppRange {
   template<class T> inline
   std::string RangeElement<T>::toString(bool compress) const {
     if(empty()) return "[]";
+    else if(full()) return "[*]";
     else if(compress && upper() == lower())
       return "[" + boost::lexical_cast<std::string>(upper()) + "]";
     else
@@ -425,6 +448,22 @@ namespace CppRange {
         ":" + boost::lexical_cast<std::string>(lower()) + "]";
   }
 
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  // check whether the range is constructed without range value
+  template<class T> inline
+  bool RangeElement<T>::unset() const {
+    return upper() == empty_upper<T>() && lower() == empty_lower<T>();
+  }
+
+  // only the default constructor makes the empty marker, given bounds
+  // with upper < lower are checked first and remain invalid
+  template<class T> inline
+  void RangeElement<T>::keep_invalid() {
+    if(upper() < lower() && unset()) r_pair.second = invalid_lower<T>();
+  }
+
   /////////////////////////////////////////////
   // overload operators
 
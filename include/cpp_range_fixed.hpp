@@ -0,0 +1,596 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * Multi-dimensional Range with a fixed number of dimensions
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_FIXED_H_
+#define _CPP_RANGE_FIXED_H_
+
+#include <ostream>
+#include <boost/array.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include "cpp_range_multi.hpp"
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // FixedRange
+  //
+  // multi-dimensional range expression with N dimensions
+  // the same as Range but the number of dimensions is a template parameter,
+  // so two FixedRange objects are always comparable and all loops
+  // have a constant trip count that the compiler can unroll
+  //
+  //////////////////////////////////////////////////
+
+  template <class T, unsigned int N>
+  class FixedRange {
+    BOOST_STATIC_ASSERT(N > 0);
+
+  public:
+    typedef boost::array<RangeElement<T>, N> range_array;
+    typedef typename range_array::iterator iterator;
+    typedef typename range_array::const_iterator const_iterator;
+
+  private:
+    range_array r_array;                                // the range array
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    FixedRange() {}                                     // an empty range
+    explicit FixedRange(const range_array&);            // construct from an array of
+                                                        // RangeElements
+    explicit FixedRange(const Range<T>&);               // convert a Range with N dimensions
+    FixedRange(const std::string&);                     // build from parsing a range text
+
+    //////////////////////////////////////////////
+    // helpers
+
+    // data accesser
+    RangeElement<T>& operator[] (unsigned int);         // access a certain dimension
+                                                        // start from the highest (left)
+    const RangeElement<T>& operator[] (unsigned int) const;
+
+    // get iterators
+    iterator begin() { return r_array.begin(); }
+    const_iterator begin() const { return r_array.begin(); }
+    iterator end() { return r_array.end(); }
+    const_iterator end() const { return r_array.end(); }
+
+    unsigned int dimension() const { return N; }        // the number of dimensions
+    T size() const;                                     // the size of the range
+    bool valid() const;                                 // ? this is a valid range
+    bool empty() const;                                 // ? this is an empty range
+    bool subset(const FixedRange&) const;               // ? this is a subset of r
+    bool proper_subset(const FixedRange&) const;        // ? this is a proper subset of r
+    bool superset(const FixedRange&) const;             // ? this is a superset of r
+    bool proper_superset(const FixedRange&) const;      // ? this is a proper superset of r
+    bool singleton() const;                             // ? this is a singleton range
+    bool equal(const FixedRange& r) const;              // ? this == r
+    bool connected(const FixedRange& r) const;          // ? this and r are connected
+    bool less(const FixedRange& r) const;               // weak order compare
+    bool overlap(const FixedRange& r) const;            // this & r != []
+    bool disjoint(const FixedRange& r) const;           // this & r == []
+    FixedRange combine(const FixedRange& r) const;      // get the union of this and r
+    FixedRange hull(const FixedRange& r) const;         // get the minimal superset of the union
+                                                        // of this and r
+    FixedRange intersection(const FixedRange& r) const; // get the intersection of this and r
+    FixedRange complement(const FixedRange& r) const;   // subtract r from this range
+    boost::tuple<FixedRange, FixedRange, FixedRange>
+    divide(const FixedRange& r) const;                  // standard divide/partition this and r
+
+    Range<T> toRange() const;                           // convert to a Range
+    std::string toString(bool compress = true) const;   // simple conversion to string
+
+  protected:
+    bool operable(const FixedRange& r) const;           // ? this and r are operable
+                                                        // only one dimension is not equal
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+
+  // construct from an array of RangeElements
+  template<class T, unsigned int N> inline
+  FixedRange<T,N>::FixedRange(const range_array& l)
+    : r_array(l) {}
+
+  // convert a Range, the number of dimensions must be N
+  template<class T, unsigned int N> inline
+  FixedRange<T,N>::FixedRange(const Range<T>& r) {
+    if(r.dimension() != N) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return;                   // an empty range
+    }
+    for(unsigned int i=0; i<N; i++)
+      r_array[i] = r[i];
+  }
+
+  // parse a range text
+  template<class T, unsigned int N> inline
+  FixedRange<T,N>::FixedRange(const std::string& str) {
+    *this = FixedRange(Range<T>(str));
+  }
+
+  //////////////////////////////////////////////
+  // data accesser
+  template<class T, unsigned int N> inline
+  RangeElement<T>& FixedRange<T,N>::operator[] (unsigned int index) {
+    return r_array.at(index);
+  }
+
+  template<class T, unsigned int N> inline
+  const RangeElement<T>& FixedRange<T,N>::operator[] (unsigned int index) const {
+    return r_array.at(index);
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  // size of bits
+  template<class T, unsigned int N> inline
+  T FixedRange<T,N>::size() const {
+    if(empty()) return T(0);
+
+    T rv(1);
+    for(unsigned int i=0; i<N; i++)
+      rv = size_mul(rv, r_array[i].size());
+    return rv;
+  }
+
+  // check whether the range expression is valid
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::valid() const {
+    for(unsigned int i=0; i<N; i++)
+      if(!r_array[i].valid()) return false;
+    return true;
+  }
+
+  // check whether the range expression is empty
+  // an invalid range element is always empty
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::empty() const {
+    for(unsigned int i=0; i<N; i++)
+      if(r_array[i].empty()) return true;
+    return false;
+  }
+
+  // check whether this is a subset of r
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::subset(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    if(empty()) return true;
+    if(r.empty()) return false;
+    for(unsigned int i=0; i<N; i++) {
+      if(!r_array[i].subset(r.r_array[i]))
+        return false;
+    }
+    return true;
+  }
+
+  // check whether this is a proper subset of r
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::proper_subset(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    if(empty()) return !r.empty();
+    if(r.empty()) return false;
+
+    bool proper = false;
+    for(unsigned int i=0; i<N; i++) {
+      if(r_array[i].equal(r.r_array[i]))
+        continue;
+      else if(r_array[i].proper_subset(r.r_array[i]))
+        proper = true;
+      else
+        return false;
+    }
+    return proper;
+  }
+
+  // check whether this is a superset of r
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::superset(const FixedRange& r) const {
+    return r.subset(*this);
+  }
+
+  // check whether this is a proper superset of r
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::proper_superset(const FixedRange& r) const {
+    return r.proper_subset(*this);
+  }
+
+  // check whether this range is a singleton range
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::singleton() const {
+    if(!valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    return empty() || size() == min_unit<T>();
+  }
+
+  // check whether r is equal with this range
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::equal(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    if(empty()) return r.empty();
+    if(r.empty()) return false;
+    for(unsigned int i=0; i<N; i++) {
+      if(!r_array[i].equal(r.r_array[i]))
+        return false;
+    }
+    return true;
+  }
+
+  // check whether the range and this range are adjacent
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::connected(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    if(empty() || r.empty()) return false;
+    for(unsigned int i=0; i<N; i++) {
+      if(!r_array[i].equal(r.r_array[i])) {
+        if(!r_array[i].connected(r.r_array[i]))
+          return false;
+      }
+    }
+    return true;
+  }
+
+  // weak order
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::less(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    if(empty()) return !r.empty();
+    if(r.empty()) return false;
+    for(unsigned int i=0; i<N; i++) {
+      if(!r_array[i].equal(r.r_array[i]))
+        return r_array[i].less(r.r_array[i]);
+    }
+    return false;               // the two ranges are equal
+  }
+
+  // whether this and r has non-empty intersection
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::overlap(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    if(empty() || r.empty())  return false;
+    for(unsigned int i=0; i<N; i++) {
+      if(!r_array[i].overlap(r.r_array[i]))
+        return false;
+    }
+    return true;
+  }
+
+  // whether this and r have no shared range
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::disjoint(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    if(empty() || r.empty())  return true;
+    for(unsigned int i=0; i<N; i++) {
+      if(!r_array[i].overlap(r.r_array[i]))
+        return true;
+    }
+    return false;
+  }
+
+  // combine two ranges
+  template<class T, unsigned int N> inline
+  FixedRange<T,N> FixedRange<T,N>::combine(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return FixedRange();
+    }
+    if(empty()) return r;
+    if(r.empty()) return *this;
+    if(!operable(r)) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonOperable(toString(), r.toString(), "|"));
+#endif
+      return FixedRange(); // or throw an exception
+    }
+
+    FixedRange rv;
+    for(unsigned int i=0; i<N; i++)
+      rv.r_array[i] = r_array[i].combine(r.r_array[i]);
+    return rv;
+  }
+
+  // get the minimal range contain the two ranges
+  template<class T, unsigned int N> inline
+  FixedRange<T,N> FixedRange<T,N>::hull(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return FixedRange();
+    }
+    if(empty()) return r;
+    if(r.empty()) return *this;
+
+    FixedRange rv;
+    for(unsigned int i=0; i<N; i++)
+      rv.r_array[i] = r_array[i].hull(r.r_array[i]);
+    return rv;
+  }
+
+  // get the shared range
+  template<class T, unsigned int N> inline
+  FixedRange<T,N> FixedRange<T,N>::intersection(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return FixedRange();
+    }
+    if(empty() || r.empty()) return FixedRange();
+
+    FixedRange rv;
+    for(unsigned int i=0; i<N; i++)
+      rv.r_array[i] = r_array[i].intersection(r.r_array[i]);
+    return rv;
+  }
+
+  // subtraction
+  template<class T, unsigned int N> inline
+  FixedRange<T,N> FixedRange<T,N>::complement(const FixedRange& r) const {
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return FixedRange();
+    }
+    if(empty()) return FixedRange();
+    if(r.empty()) return *this;
+    if(!operable(r)) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonOperable(toString(), r.toString(), "complement()"));
+#endif
+      return FixedRange(); // or throw an exception
+    }
+
+    FixedRange rv(r);
+    for(unsigned int i=0; i<N; i++) {
+      if(!r_array[i].equal(r.r_array[i])) {
+        rv.r_array[i] = r_array[i].complement(r.r_array[i]);
+        return rv;
+      }
+    }
+
+    return FixedRange();        // the two ranges are equal
+  }
+
+  // standard division
+  template<class T, unsigned int N> inline
+  boost::tuple<FixedRange<T,N>, FixedRange<T,N>, FixedRange<T,N> >
+  FixedRange<T,N>::divide(const FixedRange& r) const {
+    boost::tuple<FixedRange, FixedRange, FixedRange> rv;
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return rv;
+    }
+    if(empty() || r.empty()) {
+      boost::get<1>(rv) = hull(r);
+      return rv;
+    }
+    if(!operable(r)) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonOperable(toString(), r.toString(), "divide()"));
+#endif
+      return rv; // or throw an exception
+    }
+
+    boost::get<0>(rv) = r;
+    boost::get<1>(rv) = r;
+    boost::get<2>(rv) = r;
+
+    for(unsigned int i=0; i<N; i++) {
+      if(!r_array[i].equal(r.r_array[i])) {
+        RangeElement<T> rH, rM, rL;
+        boost::tie(rH, rM, rL) = r_array[i].divide(r.r_array[i]);
+        boost::get<0>(rv).r_array[i] = rH;
+        if(rM.empty())
+          boost::get<1>(rv) = FixedRange();
+        else
+          boost::get<1>(rv).r_array[i] = rM;
+        boost::get<2>(rv).r_array[i] = rL;
+        return rv;
+      }
+    }
+
+    // the two ranges are equal
+    boost::get<0>(rv) = FixedRange();
+    boost::get<1>(rv) = r;
+    boost::get<2>(rv) = FixedRange();
+    return rv;
+  }
+
+  // convert to a Range
+  template<class T, unsigned int N> inline
+  Range<T> FixedRange<T,N>::toRange() const {
+    Range<T> rv;
+    for(unsigned int i=0; i<N; i++)
+      rv.add_lower(r_array[i]);
+    return rv;
+  }
+
+  // convert to string
+  template<class T, unsigned int N> inline
+  std::string FixedRange<T,N>::toString(bool compress) const {
+    std::string rv;
+    if(empty()) rv = "[]";
+    else {
+      for(unsigned int i=0; i<N; i++)
+        rv += r_array[i].toString(compress);
+    }
+    return rv;
+  }
+
+  //////////////////////////////////////////////
+  // Protected Helpers
+
+  // check whether the range and this range satify the operable condition:
+  // no more than one dimension is not equal
+  template<class T, unsigned int N> inline
+  bool FixedRange<T,N>::operable(const FixedRange& r) const {
+    bool diff = false;
+    for(unsigned int i=0; i<N; i++) {
+      if(!r_array[i].equal(r.r_array[i])) {
+        if(diff) return false;  // more than one dimensions are different
+        else diff = true;
+      }
+    }
+    return true;
+  }
+
+  /////////////////////////////////////////////
+  // overload operators
+
+  // rhs range is less than lhs
+  template <class T, unsigned int N>
+  bool operator> (const FixedRange<T,N>& lhs, const FixedRange<T,N>& rhs) {
+    return rhs.less(lhs);
+  }
+
+  // rhs range is less than or equal to lhs
+  template <class T, unsigned int N>
+  bool operator>= (const FixedRange<T,N>& lhs, const FixedRange<T,N>& rhs) {
+    if(!lhs.valid() || !rhs.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    return rhs.less(lhs) || lhs.equal(rhs);
+  }
+
+  // lhs range is larger than rhs
+  template <class T, unsigned int N>
+  bool operator< (const FixedRange<T,N>& lhs, const FixedRange<T,N>& rhs) {
+    return lhs.less(rhs);
+  }
+
+  // lhs range is larger than or equal to rhs
+  template <class T, unsigned int N>
+  bool operator<= (const FixedRange<T,N>& lhs, const FixedRange<T,N>& rhs) {
+    if(!lhs.valid() || !rhs.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    return lhs.less(rhs) || lhs.equal(rhs);
+  }
+
+  // two ranges are equal
+  template <class T, unsigned int N>
+  inline bool operator== (const FixedRange<T,N>& lhs, const FixedRange<T,N>& rhs) {
+    return lhs.equal(rhs);
+  }
+
+  // two ranges are not equal
+  template <class T, unsigned int N>
+  inline bool operator!= (const FixedRange<T,N>& lhs, const FixedRange<T,N>& rhs) {
+    if(!lhs.valid() || !rhs.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    return !rhs.equal(lhs);
+  }
+
+  // return the overlapped range
+  // function does not check the result's validation
+  template <class T, unsigned int N>
+  FixedRange<T,N> operator& (const FixedRange<T,N>& lhs, const FixedRange<T,N>& rhs) {
+    return lhs.intersection(rhs);
+  }
+
+  // return the combined range
+  // function does not check the result's validation
+  template <class T, unsigned int N>
+  FixedRange<T,N> operator| (const FixedRange<T,N>& lhs, const FixedRange<T,N>& rhs) {
+    return lhs.combine(rhs);
+  }
+
+  // standard out stream
+  template<class T, unsigned int N>
+  std::ostream& operator<< (std::ostream& os, const FixedRange<T,N>& r) {
+    os << r.toString();
+    return os;
+  }
+
+}
+
+#endif
@@ -29,9 +29,16 @@
 #define _CPP_RANGE_MAP_H_
 
 #include <list>
+#include <vector>
+#include <functional>
 #include <boost/foreach.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
 
 #include "cpp_range_map_base.hpp"
+#include "cpp_range_map_iterator.hpp"
+#include "cpp_range_map_cache.hpp"
 
 namespace CppRange {
 
@@ -44,9 +51,23 @@ namespace CppRange {
   template <class T>
   class RangeMap {
   private:
-    std::list<RangeMapBase<T> > child; // sub-dimensions
+    std::vector<RangeMapBase<T> > child; // sub-dimensions
     unsigned int level;                // level of sub-ranges    
   public:
+
+    // allow snapshots and other storages to access the child list
+    friend class RangeMapSnapshot<T>;
+    friend class RangeBTree<T>;
+    friend class RangeMapCompressor<T>;
+
+    typedef RangeMapIterator<T> const_iterator;         // iterate the range vectors
+    typedef RangeMapPointIterator<T> point_iterator;    // iterate the points
+
+    // policies to find a free box
+    enum fit_policy {
+      first_fit,                                        // the lowest free box
+      best_fit                                          // the free box leaving the smallest gap
+    };
     
     //////////////////////////////////////////////
     // constructors
@@ -62,9 +83,15 @@ namespace CppRange {
     explicit RangeMap(const std::list<Range<T> >&);
                                                         // build from a list of 
                                                         // multidimensional range
+    explicit RangeMap(const RangeSet<T>&);              // convert a one dimensional set
+    RangeMap(const Range<T>&, const std::vector<boost::uint64_t>&);
+    RangeMap(const Range<T>&, const boost::uint64_t*);  // import a dense bitmask over
+                                                        // a universe
+    RangeMap(const Range<T>&, const RangeSet<T>&);      // the points of some row-major
+                                                        // offsets of a universe
     RangeMap(const std::string&);                       // build from parsing a range text
   private:
-    explicit RangeMap(const std::list<RangeMapBase<T> >&);
+    explicit RangeMap(const std::vector<RangeMapBase<T> >&);
                                                         // build from a list of 
                                                         // RangeMapBase objects
                                                         // internal use only
@@ -83,17 +110,71 @@ namespace CppRange {
     bool proper_superset( const RangeMap&) const;       // ? this is a proper superset of r
     bool singleton() const;                             // ? this is a singleton range 
     bool equal(const RangeMap& r) const;                // ? this == r 
+    bool less(const RangeMap& r) const;                 // strict order of the normalized forms
+    boost::uint64_t hash() const;                       // the structural hash of the
+                                                        // normalized form
     bool overlap(const RangeMap& r) const;              // this & r != []
     bool disjoint(const RangeMap& r) const;             // this & r == []
     RangeMap combine(const RangeMap& r) const;          // get the union of this and r
     RangeMap intersection(const RangeMap& r) const;     // get the intersection of this and r
     RangeMap complement(const RangeMap& r) const;       // subtract r from this range
+    Range<T> hull() const;                              // the smallest range vector
+                                                        // covering this range
+    const_iterator query(const Range<T>&) const;        // iterate the range vectors
+                                                        // clipped to a window
+    const_iterator begin() const;                       // the first range vector
+    const_iterator end() const;                         // the end of iteration
+    point_iterator point_begin() const;                 // the lowest point in
+                                                        // lexicographic order
+    point_iterator point_end() const;                   // the end of point iteration
+    bool contains(const std::vector<T>&) const;         // ? a point belongs to this range
+    bool contains(const T*) const;                      // ? a point (dimension() values)
+                                                        // belongs to this range
+    bool contains(const std::vector<T>&, Range<T>&) const;
+    bool contains(const T*, Range<T>&) const;           // also get the largest range vector
+                                                        // holding the point
+    std::vector<bool> contains(const std::vector<std::vector<T> >&) const;
+                                                        // check a batch of points
+    std::vector<bool> contains(const T*, std::size_t) const;
+                                                        // check a batch of n points
+                                                        // stored one after another
+    T rank(const std::vector<T>&) const;                // the number of points before a point
+    T rank(const T*) const;                             // in lexicographic order
+    std::vector<T> select(const T&) const;              // the k-th point (from 0) in
+                                                        // lexicographic order
+    template<class RNG>
+    std::vector<T> sample(RNG&) const;                  // a uniformly random point
+    template<class RNG>
+    void sample(RNG&, T*) const;                        // write a random point to a buffer
+    template<class RNG>
+    std::vector<T> sample_n(RNG&, std::size_t) const;   // n random points stored
+                                                        // one after another
+    Range<T> find_free(const std::vector<T>&, const Range<T>&, fit_policy p = first_fit) const;
+                                                        // find a box of a size inside
+                                                        // a window disjoint with this range
+    std::vector<boost::uint64_t> toBitmask(const Range<T>&) const;
+    void toBitmask(const Range<T>&, boost::uint64_t*) const;
+                                                        // export to a dense bitmask
+                                                        // over a universe
+    RangeSet<T> flatten(const Range<T>&) const;         // the row-major offsets of the
+                                                        // points inside a universe
     std::list<Range<T> > toRange() const;               // convert a RangeMap
+    RangeMap permute(const std::vector<unsigned int>&) const;
+                                                        // rebuild with dimension order[i]
+                                                        // moved to dimension i
+    std::size_t node_count() const;                     // the number of stored ranges
     
     std::string toString(bool compress = true) const;   // simple conversion to string 
 
   private:
     virtual bool comparable(const RangeMap& r) const;   // ? this and r can be compared 
+    template<class RNG>
+    static void sample(const std::vector<RangeMapBase<T> >&, RNG&, T*);
+                                                        // a random point of a range list
+    static double weight(const std::vector<RangeMapBase<T> >&);
+                                                        // the size of a range list
+                                                        // as a double
+    static double weight(const RangeMapBase<T>&);       // the size of a range as a double
 
   };
 
@@ -121,17 +202,19 @@ namespace CppRange {
   }
 
   // type conversion
+  // an empty range is stored as an empty list, as the normalized form of an empty set
   template<class T> inline
   RangeMap<T>::RangeMap(const RangeElement<T>& r) 
     : level(1) {
-    child.push_back(RangeMapBase<T>(r));
+    if(!r.valid() || !r.empty()) child.push_back(RangeMapBase<T>(r));
   }
 
   // type conversion
+  // an empty range is stored as an empty list, as the normalized form of an empty set
   template<class T> inline
   RangeMap<T>::RangeMap(const Range<T>& r)
     : level(r.dimension()) {
-    child.push_back(RangeMapBase<T>(r));
+    if(level && (!r.valid() || !r.empty())) child.push_back(RangeMapBase<T>(r));
   }
   
   // combined build
@@ -152,10 +235,86 @@ namespace CppRange {
     if(!child.empty()) level = child.front().dimension();
   }
 
+  // type conversion
+  template<class T> inline
+  RangeMap<T>::RangeMap(const RangeSet<T>& r)
+    : level(r.empty() ? 0 : 1) {
+    BOOST_FOREACH(const RangeElement<T>& e, r.ranges())
+      child.push_back(RangeMapBase<T>(e));
+    RangeMapBase<T>::accumulate(child);
+  }
+
+  // import a dense bitmask
+  // the mask must hold a bit for every point of the universe
+  template<class T> inline
+  RangeMap<T>::RangeMap(const Range<T>& universe, const std::vector<boost::uint64_t>& mask)
+    : level(0) {
+    std::vector<std::size_t> stride;
+    std::size_t n = RangeMapBase<T>::strides(universe, stride);
+    if(!universe.valid() || mask.size() * 64 < n) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return;
+    }
+    if(n) {
+      std::vector<RangeMapBase<T> > rlist = RangeMapBase<T>::fromBitmask(&mask[0], universe, &stride[0], 0, 0);
+      child.swap(rlist);
+      if(!child.empty()) level = universe.dimension();
+    }
+  }
+
+  // import a dense bitmask
+  // the point of bit i is the i-th point of the universe in row-major order
+  template<class T> inline
+  RangeMap<T>::RangeMap(const Range<T>& universe, const boost::uint64_t* mask)
+    : level(0) {
+    if(!universe.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return;
+    }
+    std::vector<std::size_t> stride;
+    if(RangeMapBase<T>::strides(universe, stride)) {
+      std::vector<RangeMapBase<T> > rlist = RangeMapBase<T>::fromBitmask(mask, universe, &stride[0], 0, 0);
+      child.swap(rlist);
+      if(!child.empty()) level = universe.dimension();
+    }
+  }
+
+  // the inverse of flatten()
+  // offsets out of the universe are dropped
+  template<class T> inline
+  RangeMap<T>::RangeMap(const Range<T>& universe, const RangeSet<T>& offsets)
+    : level(0) {
+    if(!universe.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return;
+    }
+    std::vector<T> stride;
+    T n = RangeMapBase<T>::strides(universe, stride);
+    std::vector<RangeElement<T> > rlist;        // ascending offsets inside the universe
+    for(typename std::vector<RangeElement<T> >::const_reverse_iterator it = offsets.elem.rbegin();
+        it != offsets.elem.rend(); ++it) {
+      if(!(it->lower() < n)) break;
+      if(it->upper() < T(0)) continue;
+      rlist.push_back(RangeElement<T>(it->upper() < n ? it->upper() : n - min_unit<T>(),
+                                      it->lower() < T(0) ? T(0) : it->lower()));
+    }
+    if(!rlist.empty()) {
+      std::vector<RangeMapBase<T> > rv = RangeMapBase<T>::unflatten(rlist, universe, &stride[0], 0);
+      child.swap(rv);
+      level = universe.dimension();
+    }
+  }
+
   // internal use, combined build
   // no check at all
   template<class T> inline
-  RangeMap<T>::RangeMap(const std::list<RangeMapBase<T> >& rlist)  
+  RangeMap<T>::RangeMap(const std::vector<RangeMapBase<T> >& rlist)  
     : child(rlist), level(0) {
     if(!child.empty()) level = child.front().dimension();
   }
@@ -177,8 +336,9 @@ namespace CppRange {
 
   // get the bit size of this range
   template<class T> inline
+  // the size is cached so it is not guarded by valid()
+  // an invalid range element always has a size of 0
   T RangeMap<T>::size() const {
-    if(!valid()) return T(0);  
     return RangeMapBase<T>::size(child);
   }
   
@@ -288,8 +448,12 @@ namespace CppRange {
   } 
 
   // check whether range r is equal with this range
+  // equal sets of the same dimension have equal normalized forms and hashes
+  // (an empty set is an empty list), so a different hash rejects a mismatch
+  // in O(1), invalid ranges are only reported when the hashes match
   template<class T> inline
   bool RangeMap<T>::equal(const RangeMap& r) const {
+    if(level == r.level && hash() != r.hash()) return false;
     if(!valid() || !r.valid()) {
 #ifndef CPP_RANGE_NO_EXCEPTION
       throw(RangeException_InvalidRange());
@@ -308,6 +472,41 @@ namespace CppRange {
     return RangeMapBase<T>::equal(child, r.child);
   }
 
+  // the normalized form of a set is unique, so the order of the forms
+  // (RangeMapBase::compare) is a strict total order of the sets
+  // maps of the same dimension are compared without walking their validity,
+  // an invalid range is reported when compare() reaches it
+  template<class T> inline
+  bool RangeMap<T>::less(const RangeMap& r) const {
+    if(level == r.level) {
+      if(child.empty()) return !r.child.empty();
+      if(r.child.empty()) return false;
+      return RangeMapBase<T>::compare(child, r.child) < 0;
+    }
+    if(!valid() || !r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    if(empty()) return !r.empty();
+    if(r.empty()) return false;
+    if(!comparable(r)) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), r.toString(), "<"));
+#endif
+      return false; // or throw an exception
+    }
+
+    return RangeMapBase<T>::compare(child, r.child) < 0;
+  }
+
+  // cached and updated with every list, so it costs O(1)
+  template<class T> inline
+  boost::uint64_t RangeMap<T>::hash() const {
+    return RangeMapBase<T>::list_digest(child);
+  }
+
   // check whether r has shared range with this range
   template<class T> inline
   bool RangeMap<T>::overlap(const RangeMap& r) const {
@@ -324,7 +523,7 @@ namespace CppRange {
 #endif
       return false; // or throw an exception
     }
-    return !intersection(r).empty(); // if A&B != []; then A and B are overlapped
+    return RangeMapBase<T>::overlap(child, r.child); // if A&B != []; then A and B are overlapped
   }
 
   // check whether r is disjoint with this range
@@ -343,7 +542,7 @@ namespace CppRange {
 #endif
       return false; // or throw an exception
     }
-    return intersection(r).empty(); // if A&B == []; then A and B are disjoint
+    return !RangeMapBase<T>::overlap(child, r.child); // if A&B == []; then A and B are disjoint
   }
 
   // combine two ranges
@@ -405,10 +604,343 @@ namespace CppRange {
     return RangeMap(RangeMapBase<T>::complement(child, r.child));
   }
 
+  // get the hull from the cached hulls of the top-level ranges
+  template<class T> inline
+  Range<T> RangeMap<T>::hull() const {
+    return RangeMapBase<T>::hull(child);
+  }
+
+  // iterate the range vectors overlapped with a window, clipped to the window
+  // neither the window nor the intersection is built as a RangeMap
+  template<class T> inline
+  typename RangeMap<T>::const_iterator RangeMap<T>::query(const Range<T>& window) const {
+    if(!window.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return end();
+    }
+    if(child.empty() || window.empty()) return end();
+    if(window.dimension() != level) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), window.toString(), "query()"));
+#endif
+      return end();
+    }
+    return const_iterator(child, window);
+  }
+
+  // iterate all range vectors, O(depth) memory
+  template<class T> inline
+  typename RangeMap<T>::const_iterator RangeMap<T>::begin() const {
+    return const_iterator(child);
+  }
+
+  template<class T> inline
+  typename RangeMap<T>::const_iterator RangeMap<T>::end() const {
+    return const_iterator();
+  }
+
+  // iterate all points in lexicographic order, O(depth) memory
+  template<class T> inline
+  typename RangeMap<T>::point_iterator RangeMap<T>::point_begin() const {
+    return point_iterator(child);
+  }
+
+  template<class T> inline
+  typename RangeMap<T>::point_iterator RangeMap<T>::point_end() const {
+    return point_iterator();
+  }
+
+  // check whether a point belongs to this range
+  // binary search each level, O(d log n) without heap allocation
+  // not guarded by valid() as validation walks the whole tree
+  // an empty range holds no point of any dimension
+  template<class T> inline
+  bool RangeMap<T>::contains(const std::vector<T>& point) const {
+    if(level && point.size() != level) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), point_string(point), "contains()"));
+#endif
+      return false;
+    }
+    return level && contains(&point[0]);
+  }
+
+  template<class T> inline
+  bool RangeMap<T>::contains(const T* point) const {
+    const std::vector<RangeMapBase<T> >* rlist = &child;
+    for(unsigned int i=0; i<level; i++) {
+      const RangeMapBase<T>* b = RangeMapBase<T>::find(*rlist, point[i]);
+      if(!b) return false;
+      rlist = &(b->child);
+    }
+    return level != 0;
+  }
+
+  template<class T> inline
+  bool RangeMap<T>::contains(const std::vector<T>& point, Range<T>& box) const {
+    if(level && point.size() != level) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), point_string(point), "contains()"));
+#endif
+      box = Range<T>();
+      return false;
+    }
+    return contains(point.empty() ? NULL : &point[0], box);
+  }
+
+  template<class T> inline
+  bool RangeMap<T>::contains(const T* point, Range<T>& box) const {
+    box = Range<T>();
+    const std::vector<RangeMapBase<T> >* rlist = &child;
+    for(unsigned int i=0; i<level; i++) {
+      const RangeMapBase<T>* b = RangeMapBase<T>::find(*rlist, point[i]);
+      if(!b) {
+        box = Range<T>();
+        return false;
+      }
+      box.add_lower(*b);
+      rlist = &(b->child);
+    }
+    return level != 0;
+  }
+
+  // check a batch of points in one merge-style pass per level
+  // about O(n + q) for n ranges and q points if the points are in ascending
+  // order, otherwise the points are sorted first
+  template<class T> inline
+  std::vector<bool> RangeMap<T>::contains(const std::vector<std::vector<T> >& points) const {
+    std::vector<typename RangeMapBase<T>::point_ref> prefs;
+    if(level) {
+      for(std::size_t i=0; i<points.size(); i++) {
+        if(points[i].size() != level) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+          throw(RangeException_NonComparable(toString(), point_string(points[i]), "contains()"));
+#endif
+          return std::vector<bool>(points.size(), false);
+        }
+        prefs.push_back(typename RangeMapBase<T>::point_ref(&points[i][0], i));
+      }
+    }
+    std::vector<bool> rv(points.size(), false);
+    RangeMapBase<T>::contains(child, prefs.begin(), prefs.end(), 0, rv);
+    return rv;
+  }
+
+  template<class T> inline
+  std::vector<bool> RangeMap<T>::contains(const T* points, std::size_t n) const {
+    std::vector<typename RangeMapBase<T>::point_ref> prefs;
+    if(level) {
+      for(std::size_t i=0; i<n; i++)
+        prefs.push_back(typename RangeMapBase<T>::point_ref(points + i*level, i));
+    }
+    std::vector<bool> rv(n, false);
+    RangeMapBase<T>::contains(child, prefs.begin(), prefs.end(), 0, rv);
+    return rv;
+  }
+
+  // the number of points before a point in lexicographic order
+  // (from the highest dimension) using the cached sizes, O(d log n)
+  template<class T> inline
+  T RangeMap<T>::rank(const std::vector<T>& point) const {
+    if(level && point.size() != level) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), point_string(point), "rank()"));
+#endif
+      return T(0);
+    }
+    return level ? rank(&point[0]) : T(0);
+  }
+
+  template<class T> inline
+  T RangeMap<T>::rank(const T* point) const {
+    return RangeMapBase<T>::rank(child, point);
+  }
+
+  // the k-th point in lexicographic order, the inverse of rank()
+  // return an empty vector if k is not smaller than size()
+  template<class T> inline
+  std::vector<T> RangeMap<T>::select(const T& k) const {
+    if(k < T(0) || !(k < size())) return std::vector<T>();
+    std::vector<T> rv(level);
+    RangeMapBase<T>::select(child, k, &rv[0]);
+    return rv;
+  }
+
+  // draw a uniformly random point
+  // a random rank is drawn and the point is selected by the cached sizes,
+  // O(d log n) per point
+  // when the size saturates (such as with a wildcard), the point is drawn
+  // level by level instead, O(number of nodes) per point
+  // return an empty vector for an empty range
+  template<class T> template<class RNG> inline
+  std::vector<T> RangeMap<T>::sample(RNG& rng) const {
+    if(size() == T(0)) return std::vector<T>();
+    std::vector<T> rv(level);
+    sample(rng, &rv[0]);
+    return rv;
+  }
+
+  // no allocation, the buffer must hold dimension() values
+  // the buffer is untouched for an empty range
+  template<class T> template<class RNG> inline
+  void RangeMap<T>::sample(RNG& rng, T* point) const {
+    if(size() == T(0)) return;
+    sample(child, rng, point);
+  }
+
+  template<class T> template<class RNG> inline
+  std::vector<T> RangeMap<T>::sample_n(RNG& rng, std::size_t n) const {
+    if(size() == T(0)) return std::vector<T>();
+    std::vector<T> rv(n * level);
+    if(is_largest(size())) {
+      for(std::size_t i=0; i<n; i++)
+        sample(child, rng, &rv[i*level]);
+      return rv;
+    }
+    boost::random::uniform_int_distribution<T> dist(T(0), size() - T(1));
+    for(std::size_t i=0; i<n; i++)
+      RangeMapBase<T>::select(child, dist(rng), &rv[i*level]);
+    return rv;
+  }
+
+  // find a free box of a given size per dimension inside a window
+  // by walking the gaps between ranges, no complement is computed
+  // return an empty Range if no box fits
+  template<class T> inline
+  Range<T> RangeMap<T>::find_free(const std::vector<T>& extent, const Range<T>& within,
+                                  fit_policy p) const {
+    if(!within.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return Range<T>();
+    }
+    if(within.empty()) return Range<T>();
+    if(extent.size() != within.dimension() || (level && level != within.dimension())) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), within.toString(), "find_free()"));
+#endif
+      return Range<T>();
+    }
+    for(unsigned int i=0; i<extent.size(); i++)
+      if(!(T(0) < extent[i])) return Range<T>();
+
+    std::vector<const std::vector<RangeMapBase<T> >*> lists(1, &child);
+    std::vector<T> corner(extent.size());
+    if(!RangeMapBase<T>::find_free(lists, &extent[0], within, 0, p == best_fit, &corner[0]))
+      return Range<T>();
+
+    Range<T> rv;
+    for(unsigned int i=0; i<corner.size(); i++)
+      rv.add_lower(RangeElement<T>(corner[i] + (extent[i] - min_unit<T>()), corner[i]));
+    return rv;
+  }
+
+  // export to a dense bitmask
+  // a word for every 64 points of the universe, no word if not operable
+  template<class T> inline
+  std::vector<boost::uint64_t> RangeMap<T>::toBitmask(const Range<T>& universe) const {
+    std::vector<boost::uint64_t> rv;
+    std::vector<std::size_t> stride;
+    if(valid() && universe.valid() && (!level || level == universe.dimension()))
+      rv.resize((RangeMapBase<T>::strides(universe, stride) + 63) / 64);
+    toBitmask(universe, rv.empty() ? NULL : &rv[0]);
+    return rv;
+  }
+
+  // export to a dense bitmask
+  // the point of bit i is the i-th point of the universe in row-major order,
+  // points out of the universe are dropped
+  template<class T> inline
+  void RangeMap<T>::toBitmask(const Range<T>& universe, boost::uint64_t* mask) const {
+    if(!valid() || !universe.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return;
+    }
+    if(level && level != universe.dimension()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), universe.toString(), "toBitmask()"));
+#endif
+      return;
+    }
+    std::vector<std::size_t> stride;
+    std::size_t n = RangeMapBase<T>::strides(universe, stride);
+    std::fill(mask, mask + (n + 63) / 64, boost::uint64_t(0));
+    if(n) RangeMapBase<T>::toBitmask(child, universe, &stride[0], 0, 0, mask);
+  }
+
+  // the row-major offsets of the points inside a universe
+  // the lowest point is offset 0 and the last dimension changes the fastest,
+  // runs contiguous across rows are merged
+  template<class T> inline
+  RangeSet<T> RangeMap<T>::flatten(const Range<T>& universe) const {
+    RangeSet<T> rv;
+    if(!valid() || !universe.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return rv;
+    }
+    if(level && level != universe.dimension()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(toString(), universe.toString(), "flatten()"));
+#endif
+      return rv;
+    }
+    std::vector<T> stride;
+    if(level && RangeMapBase<T>::strides(universe, stride) != T(0)) {
+      RangeMapBase<T>::flatten(child, universe, &stride[0], 0, rv.elem);
+      std::reverse(rv.elem.begin(), rv.elem.end());
+    }
+    return rv;
+  }
+
   // convert to a list of ranges
+  // use begin() and end() to avoid building the whole list
   template<class T> inline
   std::list<Range<T> > RangeMap<T>::toRange() const {
-    return RangeMapBase<T>::toRange(child);
+    return std::list<Range<T> >(begin(), end());
+  }
+
+  // every range vector is permuted and the disjoint vectors are combined
+  // in a balanced tree of unions, so the result is normalized in the new order
+  // the number of nodes may change a lot, see RangeMapView
+  template<class T> inline
+  RangeMap<T> RangeMap<T>::permute(const std::vector<unsigned int>& order) const {
+    if(empty()) return RangeMap();
+    std::vector<bool> used(level, false);
+    bool legal = valid() && order.size() == level;
+    for(unsigned int i = 0; legal && i < order.size(); i++) {
+      legal = order[i] < level && !used[order[i]];
+      if(legal) used[order[i]] = true;
+    }
+    if(!legal) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return RangeMap();
+    }
+
+    std::vector<RangeMap> parts;
+    std::vector<RangeElement<T> > box(level);
+    for(const_iterator it = begin(); it != end(); ++it) {
+      for(unsigned int i = 0; i < level; i++)
+        box[i] = (*it)[order[i]];
+      parts.push_back(RangeMap(Range<T>(box)));
+    }
+    for(std::size_t step = 1; step < parts.size(); step *= 2)
+      for(std::size_t i = 0; i + step < parts.size(); i += 2 * step)
+        parts[i] = parts[i].combine(parts[i + step]);
+    return parts.front();
+  }
+
+  template<class T> inline
+  std::size_t RangeMap<T>::node_count() const {
+    return RangeMapBase<T>::node_count(child);
   }
 
   // convert to string
@@ -430,6 +962,49 @@ namespace CppRange {
     return level == r.level;
   }
 
+  // a list whose cached size is exact draws a rank, otherwise a range is
+  // picked by its weight, a value is drawn inside it and its children are
+  // sampled, which is uniform as all values of a range share the children
+  template<class T> template<class RNG> inline
+  void RangeMap<T>::sample(const std::vector<RangeMapBase<T> >& rlist, RNG& rng, T* point) {
+    T s = RangeMapBase<T>::size(rlist);
+    if(!is_largest(s)) {
+      boost::random::uniform_int_distribution<T> dist(T(0), s - T(1));
+      RangeMapBase<T>::select(rlist, dist(rng), point);
+      return;
+    }
+
+    std::vector<double> accum(rlist.size());
+    double total = 0.0;
+    for(unsigned int i=0; i<rlist.size(); i++)
+      accum[i] = total += weight(rlist[i]);
+    boost::random::uniform_real_distribution<double> pick(0.0, total);
+    unsigned int i = std::upper_bound(accum.begin(), accum.end(), pick(rng)) - accum.begin();
+    if(i == rlist.size()) --i;
+
+    const RangeMapBase<T>& b = rlist[i];
+    boost::random::uniform_int_distribution<T> value(b.lower(), b.upper());
+    *point = value(rng);
+    if(!b.child.empty()) sample(b.child, rng, point + 1);
+  }
+
+  // the cached size is used unless it saturates
+  template<class T> inline
+  double RangeMap<T>::weight(const std::vector<RangeMapBase<T> >& rlist) {
+    T s = RangeMapBase<T>::size(rlist);
+    if(!is_largest(s)) return static_cast<double>(s);
+    double rv = 0.0;
+    BOOST_FOREACH(const RangeMapBase<T>& b, rlist)
+      rv += weight(b);
+    return rv;
+  }
+
+  template<class T> inline
+  double RangeMap<T>::weight(const RangeMapBase<T>& b) {
+    double rv = static_cast<double>(b.upper()) - static_cast<double>(b.lower()) + 1.0;
+    return b.child.empty() ? rv : rv * weight(b.child);
+  }
+
 
   /////////////////////////////////////////////
   // overload operators
@@ -452,6 +1027,33 @@ namespace CppRange {
     return !rhs.equal(lhs);
   }
 
+  // strict order, so RangeMap can be the key of std::map and std::set
+  template <class T>
+  inline bool operator< (const RangeMap<T>& lhs, const RangeMap<T>& rhs) {
+    return lhs.less(rhs);
+  }
+
+  template <class T>
+  inline bool operator> (const RangeMap<T>& lhs, const RangeMap<T>& rhs) {
+    return rhs.less(lhs);
+  }
+
+  template <class T>
+  inline bool operator<= (const RangeMap<T>& lhs, const RangeMap<T>& rhs) {
+    return !rhs.less(lhs);
+  }
+
+  template <class T>
+  inline bool operator>= (const RangeMap<T>& lhs, const RangeMap<T>& rhs) {
+    return !lhs.less(rhs);
+  }
+
+  // the structural hash for boost::hash and boost::unordered containers
+  template <class T>
+  inline std::size_t hash_value(const RangeMap<T>& r) {
+    return static_cast<std::size_t>(r.hash());
+  }
+
   // return the overlapped range
   // function does not check the result's validation
   template <class T>  
@@ -475,5 +1077,18 @@ namespace CppRange {
 
 }
 
+#if __cplusplus >= 201103L
+namespace std {
+
+  // the structural hash for std::unordered_set and std::unordered_map
+  template <class T>
+  struct hash<CppRange::RangeMap<T> > {
+    std::size_t operator() (const CppRange::RangeMap<T>& r) const {
+      return static_cast<std::size_t>(r.hash());
+    }
+  };
+
+}
+#endif
 
 #endif
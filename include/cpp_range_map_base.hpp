@@ -29,10 +29,17 @@
 #define _CPP_RANGE_MAP_BASE_H_
 
 #include <list>
+#include <vector>
+#include <algorithm>
 #include <boost/foreach.hpp>
 #include <boost/tuple/tuple.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "cpp_range_multi.hpp"
+#include "cpp_range_bitmap.hpp"
+#include "cpp_range_set.hpp"
 
 namespace CppRange {
 
@@ -44,17 +51,41 @@ namespace CppRange {
   // RangeMapBase
   //
   // store the current range and its child ranges of RangeMap
+  // the level of a node is implied by its depth:
+  // a leaf range has no child and all children of a node 
+  // have the same number of dimensions
+  // every node caches the size of itself and all its lower siblings,
+  // so the size of a list is the cache of its first node
+  // the hull of the child ranges in each lower dimension is known, so
+  // subtrees out of reach of the other operand are skipped
+  // the child dimension of the hull is read from the first and last child,
+  // the deeper dimensions are cached out of line only by nodes with
+  // grandchildren, so a leaf or a node of leaves carries a null pointer
+  // and a structural digest of itself and its lower siblings, used as the
+  // key of the operation cache (RangeMapCache)
   //
   //////////////////////////////////////////////////
   template <class T>
   class RangeMapBase : public RangeElement<T> {
   private:
-    std::list<RangeMapBase> child;    // sub-dimensions
-    unsigned int level;               // level of sub-ranges
+    std::vector<RangeMapBase> child;    // sub-dimensions
+    T accum;                            // the size of this range and all lower
+                                        // ranges in the same list (cached)
+    boost::shared_ptr<const Range<T> > bound;
+                                        // the hull of all grandchild ranges in each
+                                        // lower dimension (cached, shared by copies)
+    boost::uint64_t digest;             // the structural hash of this range and all
+                                        // lower ranges in the same list (cached)
   public:
 
     // allow RangeMap to use protected member functions
     friend class RangeMap<T>;
+    friend class RangeMapSnapshot<T>;
+    friend class RangeBTree<T>;
+    friend class RangeMapIterator<T>;
+    friend class RangeMapPointIterator<T>;
+    friend class RangeMapCache<T>;
+    friend class RangeMapCompressor<T>;
 
     //////////////////////////////////////////////
     // constructors
@@ -64,7 +95,7 @@ namespace CppRange {
     RangeMapBase(const T&, const T&);                   // single level range
     explicit RangeMapBase(const RangeElement<T>&);      // range element to range map base
     explicit RangeMapBase(const Range<T>&);             // multidimensional range to range map base
-    explicit RangeMapBase(const RangeElement<T>&, const std::list<RangeMapBase>&);
+    explicit RangeMapBase(const RangeElement<T>&, const std::vector<RangeMapBase>&);
                                                         // multidimensional range map base
     template<class InputIterator>
     RangeMapBase(const RangeElement<T>&, InputIterator first, InputIterator last);
@@ -92,36 +123,84 @@ namespace CppRange {
     std::list<Range<T> > toRange() const;               // convert a RangeMap to Ranges
     std::string toString(bool compress = true) const;   // simple conversion to string 
   protected:
+    // a point in a batched query and its index in the batch
+    typedef std::pair<const T*, std::size_t> point_ref;
 
-    void set_child(const std::list<RangeMapBase>&);     // set a new child range list 
+    void set_child(const std::vector<RangeMapBase>&);     // set a new child range list 
     bool add_child(const RangeMapBase&);                // insert a sub-range to the child list
     
     //////////////////////////////////
     // static helper functions
 
-    static T size(const std::list<RangeMapBase>&);      // calculate the bit size of a range list
-    static bool empty(const std::list<RangeMapBase>&);  // ? a range list is empty
-    static bool valid(const std::list<RangeMapBase>&, unsigned int level);  
+    static T size(const std::vector<RangeMapBase>&);      // calculate the bit size of a range list
+    static boost::uint64_t list_digest(const std::vector<RangeMapBase>&);
+                                                        // the structural hash of a range list
+    static std::size_t node_count(const std::vector<RangeMapBase>&);
+                                                        // the number of nodes of a range list
+                                                        // and all its descendants
+    static Range<T> hull(const std::vector<RangeMapBase>&); // the hull of a range list
+    static bool empty(const std::vector<RangeMapBase>&);  // ? a range list is empty
+    static bool valid(const std::vector<RangeMapBase>&, unsigned int level);  
                                                         // ? a range list is valid
-    static bool subset(const std::list<RangeMapBase>&, const std::list<RangeMapBase>&);
+    static bool subset(const std::vector<RangeMapBase>&, const std::vector<RangeMapBase>&);
                                                         // subset relation of two range lists
-    static bool equal(const std::list<RangeMapBase>&, const std::list<RangeMapBase>&);
+    static bool equal(const std::vector<RangeMapBase>&, const std::vector<RangeMapBase>&);
                                                         // ? two range lists are equal
-    static std::list<RangeMapBase> 
-    combine(const std::list<RangeMapBase>&, const std::list<RangeMapBase>&);
+    static int compare(const std::vector<RangeMapBase>&, const std::vector<RangeMapBase>&);
+                                                        // the order of two range lists
+                                                        // -1, 0 or 1
+    static bool overlap(const std::vector<RangeMapBase>&, const std::vector<RangeMapBase>&);
+                                                        // ? two range lists are overlapped
+    static std::vector<RangeMapBase> 
+    combine(const std::vector<RangeMapBase>&, const std::vector<RangeMapBase>&);
                                                         // combine two range lists
-    static std::list<RangeMapBase>
-    intersection(const std::list<RangeMapBase>&, const std::list<RangeMapBase>&);
+    static std::vector<RangeMapBase>
+    intersection(const std::vector<RangeMapBase>&, const std::vector<RangeMapBase>&);
                                                         // get the intersection of two range lists
-    static std::list<RangeMapBase>
-    complement(const std::list<RangeMapBase>&, const std::list<RangeMapBase>&);
+    static std::vector<RangeMapBase>
+    complement(const std::vector<RangeMapBase>&, const std::vector<RangeMapBase>&);
                                                         // get the result of list l - list r
-    static void normalize(std::list<RangeMapBase>&);    // normalize a range list
-    static void add_child(std::list<RangeMapBase>&, const RangeMapBase&);
+    static void normalize(std::vector<RangeMapBase>&);    // normalize a range list
+    static void add_child(std::vector<RangeMapBase>&, const RangeMapBase&);
                                                         // add a Range into a list of ranges
-    static std::list<Range<T> > toRange(const std::list<RangeMapBase>&);
+    static const RangeMapBase* find(const std::vector<RangeMapBase>&, const T&);
+                                                        // the range holding a value
+    static void accumulate(std::vector<RangeMapBase>&);   // update the cached values of a list
+    static T rank(const std::vector<RangeMapBase>&, const T*);
+                                                        // the number of points before a point
+    static void select(const std::vector<RangeMapBase>&, T, T*);
+                                                        // the k-th point of a range list
+    static bool find_free(const std::vector<const std::vector<RangeMapBase>*>&, const T*,
+                          const Range<T>&, unsigned int, bool, T*);
+                                                        // the lowest free box of a size
+                                                        // avoiding some range lists
+    static void contains(const std::vector<RangeMapBase>&,
+                         typename std::vector<point_ref>::iterator,
+                         typename std::vector<point_ref>::iterator,
+                         unsigned int, std::vector<bool>&);
+                                                        // mark the batched points belonging
+                                                        // to a range list
+    template<class S>
+    static S strides(const Range<T>&, std::vector<S>&); // the row-major strides of the
+                                                        // dimensions of a universe
+                                                        // and its number of points
+    static void toBitmask(const std::vector<RangeMapBase>&, const Range<T>&,
+                          const std::size_t*, unsigned int, std::size_t, boost::uint64_t*);
+                                                        // set the bits of a range list
+    static std::vector<RangeMapBase>
+    fromBitmask(const boost::uint64_t*, const Range<T>&, const std::size_t*, unsigned int,
+                std::size_t);                           // the range list of a block of bits
+    static void flatten(const std::vector<RangeMapBase>&, const Range<T>&, const T*,
+                        unsigned int, std::vector<RangeElement<T> >&);
+                                                        // the row-major offsets of a range
+                                                        // list inside its block
+    static std::vector<RangeMapBase>
+    unflatten(const std::vector<RangeElement<T> >&, const Range<T>&, const T*, unsigned int);
+                                                        // the range list of a block holding
+                                                        // some row-major offsets
+    static std::list<Range<T> > toRange(const std::vector<RangeMapBase>&);
                                                         // convert a RangeMap to Ranges
-    static std::string toString(const std::list<RangeMapBase>&, bool compress = true);
+    static std::string toString(const std::vector<RangeMapBase>&, bool compress = true);
                                                         // simple conversion to string 
 
   private:
@@ -147,6 +226,50 @@ namespace CppRange {
     void overlap();
     void disjoint();
     void complement();
+
+    void refresh();                                     // update the cached values of a
+                                                        // single range
+    void refresh_bound();                               // update the cached hull
+    unsigned int bound_dimension() const;               // the dimensions of the child hull
+    RangeElement<T> bound_at(unsigned int) const;       // the child hull in a lower dimension
+    boost::uint64_t node_digest() const;                // the structural hash of a range
+    static boost::uint64_t mix(boost::uint64_t, boost::uint64_t);
+                                                        // combine two hash values
+
+    // compare the cached hulls of the children of two ranges
+    static bool bound_overlap(const RangeMapBase&, const RangeMapBase&);
+    static bool bound_subset(const RangeMapBase&, const RangeMapBase&);
+
+    static bool leaf(const std::vector<RangeMapBase>&, const std::vector<RangeMapBase>&);
+                                                        // ? two lists of leaf ranges
+    static bool wildcard(const std::vector<RangeMapBase>&);
+                                                        // ? a list of a single wildcard
+    static bool universal(const std::vector<RangeMapBase>&);
+                                                        // ? a list of wildcards down to
+                                                        // the last dimension
+    enum wild_op { wild_combine, wild_intersection, wild_complement, complement_wild };
+    static std::vector<RangeMapBase>
+    wild(const RangeMapBase&, const std::vector<RangeMapBase>&, wild_op);
+                                                        // operate a wildcard range with
+                                                        // a range list
+    static bool wild_subset(const RangeMapBase&, const std::vector<RangeMapBase>&);
+                                                        // ? a wildcard range is a subset
+                                                        // of a range list
+    static void append(std::vector<RangeMapBase>&, const RangeMapBase&);
+                                                        // append a lower range to a list
+    static bool dense(const std::vector<RangeMapBase>&, const std::vector<RangeMapBase>&,
+                      RangeBitmap<T>&, RangeBitmap<T>&);
+                                                        // turn two fragmented leaf range
+                                                        // lists into bitmaps
+
+    // order points by one coordinate
+    struct point_less {
+      unsigned int l;
+      explicit point_less(unsigned int l_arg) : l(l_arg) {}
+      bool operator() (const point_ref& lhs, const point_ref& rhs) const {
+        return lhs.first[l] < rhs.first[l];
+      }
+    };
   };
 
   /////////////////////////////////////////////
@@ -156,28 +279,36 @@ namespace CppRange {
   // default to construct an range with undefined value
   template<class T> inline
   RangeMapBase<T>::RangeMapBase()
-    : RangeElement<T>(), level(0) {}
+    : RangeElement<T>() {
+    refresh();
+  }
 
   // single bit range
   template<class T> inline
   RangeMapBase<T>::RangeMapBase(const T& r)
-    : RangeElement<T>(r), level(1) {}
+    : RangeElement<T>(r) {
+    refresh();
+  }
 
   // bit range
   template<class T> inline
   RangeMapBase<T>::RangeMapBase(const T& rh, const T& rl)
-    : RangeElement<T>(rh, rl), level(1) {}
+    : RangeElement<T>(rh, rl) {
+    refresh();
+  }
 
   // type conversion
   template<class T> inline
   RangeMapBase<T>::RangeMapBase(const RangeElement<T>& r)
-    : RangeElement<T>(r), level(1) {}
+    : RangeElement<T>(r) {
+    refresh();
+  }
 
   // type conversion
   template<class T> inline
-  RangeMapBase<T>::RangeMapBase(const Range<T>& r) 
-    :level(0) {
-    typename std::vector<RangeElement<T> >::const_iterator it = r.begin();
+  RangeMapBase<T>::RangeMapBase(const Range<T>& r) {
+    refresh();
+    typename Range<T>::const_iterator it = r.begin();
     if(it != r.end()) {
       RangeElement<T> base_range = *it++;
       *this = RangeMapBase(base_range, it, r.end());
@@ -186,10 +317,9 @@ namespace CppRange {
 
   // combined build
   template<class T> inline
-  RangeMapBase<T>::RangeMapBase(const RangeElement<T>& r, const std::list<RangeMapBase>& rlist)
+  RangeMapBase<T>::RangeMapBase(const RangeElement<T>& r, const std::vector<RangeMapBase>& rlist)
     : RangeElement<T>(r), child(rlist) {
-    if(child.empty()) level = 1;
-    else              level = child.front().level + 1;
+    refresh();
   }
 
   // build a multidimensional range map using iterators
@@ -199,10 +329,8 @@ namespace CppRange {
     if(first != last) {
       RangeElement<T> base_range = *first++;
       child.push_back(RangeMapBase(base_range, first, last));
-      level = child.front().level + 1;
-    } else {
-      level = 1;
     }
+    refresh();
   }
 
   //////////////////////////////////////////////
@@ -211,26 +339,30 @@ namespace CppRange {
   // get the number of dimensions
   template<class T> inline
   unsigned int RangeMapBase<T>::dimension() const {
-    return level;
+    unsigned int rv = 1;
+    for(const RangeMapBase* b = this; !b->child.empty(); b = &(b->child.front()))
+      ++rv;
+    return rv;
   }
     
   // get the size of this range
+  // the size of the child list is cached
   template<class T> inline
   T RangeMapBase<T>::size() const {
     if(child.empty()) return RangeElement<T>::size(); // leaf node
-    return size(child) * RangeElement<T>::size();
+    return size_mul(size(child), RangeElement<T>::size());
   }
   
   // whether the range is valid
   template<class T> inline
   bool RangeMapBase<T>::valid() const {
-    return RangeElement<T>::valid() && valid(child, level - 1);
+    return RangeElement<T>::valid() && valid(child, dimension() - 1);
   }
   
   // whether the range is empty
   template<class T> inline
   bool RangeMapBase<T>::empty() const {
-    return RangeElement<T>::empty() || empty(child) || (child.empty() && level > 1);
+    return RangeElement<T>::empty() || empty(child);
   }
 
   // check whether range r is equal with this range
@@ -288,7 +420,7 @@ namespace CppRange {
   template<class T> inline
   RangeMapBase<T> RangeMapBase<T>::intersection(const RangeMapBase& r) const {
     RangeMapBase rv(RangeElement<T>::intersection(r), intersection(child, r.child));
-    if(rv.level != level) return RangeMapBase();
+    if(rv.child.empty() && !child.empty()) return RangeMapBase(); // lower dimensions empty
     else return rv;
   }
   
@@ -315,12 +447,9 @@ namespace CppRange {
   // protected helper functions
 
   template<class T> inline
-  void RangeMapBase<T>::set_child(const std::list<RangeMapBase>& c) {
+  void RangeMapBase<T>::set_child(const std::vector<RangeMapBase>& c) {
     child = c;
-    if(c.empty())
-      level = 1;
-    else
-      level = 1 + c.front().level;      
+    refresh();
   }
 
   // insert a sub-range
@@ -328,33 +457,115 @@ namespace CppRange {
   bool RangeMapBase<T>::add_child(const RangeMapBase& r) {
     if(r.empty()) return false;
     
-    if(child.empty())
-      level = r.level + 1;
-    else if(level != r.level + 1)
+    if(!child.empty() && child.front().dimension() != r.dimension())
       return false;
 
     add_child(child, r);
+    refresh();
     return true;
   }
 
+  // a single range is a list of its own
+  template<class T> inline
+  void RangeMapBase<T>::refresh() {
+    accum = size();
+    refresh_bound();
+    digest = mix(node_digest(), 0);
+  }
+
+  template<class T> inline
+  void RangeMapBase<T>::refresh_bound() {
+    if(child.empty() || child.front().child.empty()) {
+      bound.reset();
+      return;
+    }
+    Range<T> h = hull(child);
+    h.remove_upper();
+    bound.reset(new Range<T>(h));
+  }
+
+  template<class T> inline
+  unsigned int RangeMapBase<T>::bound_dimension() const {
+    if(child.empty()) return 0;
+    return bound ? bound->dimension() + 1 : 1;
+  }
+
+  // 0 is the child dimension
+  template<class T> inline
+  RangeElement<T> RangeMapBase<T>::bound_at(unsigned int l) const {
+    if(l == 0) return RangeElement<T>(child.front().upper(), child.back().lower());
+    return (*bound)[l-1];
+  }
+
+  template<class T> inline
+  boost::uint64_t RangeMapBase<T>::node_digest() const {
+    boost::hash<T> h;
+    return mix(mix(h(RangeElement<T>::upper()), h(RangeElement<T>::lower())), list_digest(child));
+  }
+
+  // the finalizer of splitmix64 on the combined value
+  template<class T> inline
+  boost::uint64_t RangeMapBase<T>::mix(boost::uint64_t h, boost::uint64_t v) {
+    boost::uint64_t z = h ^ (v + 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
   //////////////////////////////////
   // static helper functions
 
   // claculat the bit size
   template<class T> inline
-  T RangeMapBase<T>::size(const std::list<RangeMapBase>& rlist) {
+  T RangeMapBase<T>::size(const std::vector<RangeMapBase>& rlist) {
     // will not check the validation, the non-static method should check it
-    T rv(0);
-    BOOST_FOREACH(const RangeMapBase& b, rlist)
-      rv = rv + b.size();  // disable check
+    return rlist.empty() ? T(0) : rlist.front().accum;
+  }
+
+  // get the structural hash of a range list
+  template<class T> inline
+  boost::uint64_t RangeMapBase<T>::list_digest(const std::vector<RangeMapBase>& rlist) {
+    return rlist.empty() ? 0 : rlist.front().digest;
+  }
+
+  // count the nodes of a range list
+  template<class T> inline
+  std::size_t RangeMapBase<T>::node_count(const std::vector<RangeMapBase>& rlist) {
+    std::size_t rv = rlist.size();
+    BOOST_FOREACH(const RangeMapBase<T>& r, rlist)
+      rv += node_count(r.child);
+    return rv;
+  }
+
+  // the hull of a range list
+  // the first dimension is bounded by the first and last ranges and
+  // the lower dimensions are the union of the cached hulls
+  template<class T> inline
+  Range<T> RangeMapBase<T>::hull(const std::vector<RangeMapBase>& rlist) {
+    Range<T> rv;
+    if(rlist.empty()) return rv;
+    rv.add_lower(RangeElement<T>(rlist.front().upper(), rlist.back().lower()));
+    for(unsigned int l=0; l<rlist.front().bound_dimension(); l++)
+      rv.add_lower(rlist.front().bound_at(l));
+    for(unsigned int i=1; i<rlist.size(); i++) {
+      for(unsigned int l=0; l<rlist[i].bound_dimension(); l++) {
+        RangeElement<T> r = rlist[i].bound_at(l);
+        RangeElement<T>& h = rv[l+1];
+        if(h.upper() < r.upper()) h.upper(r.upper());
+        if(r.lower() < h.lower()) h.lower(r.lower());
+      }
+    }
     return rv;
   }
 
   // valid range expression
+  // all ranges in the list should have 'l' dimensions
   template<class T> inline
-  bool RangeMapBase<T>::valid(const std::list<RangeMapBase>& rlist, unsigned int l) {
+  bool RangeMapBase<T>::valid(const std::vector<RangeMapBase>& rlist, unsigned int l) {
     BOOST_FOREACH(const RangeMapBase& b, rlist)
-      if(!b.valid() || l != b.level) {
+      if(!b.RangeElement<T>::valid()                          // illegal range
+         || (l == 1) != b.child.empty()                       // wrong depth
+         || !valid(b.child, l - 1)) {
         return false;
       }
     return true;
@@ -362,7 +573,7 @@ namespace CppRange {
 
   // check whether the child list is empty
   template<class T> inline
-  bool RangeMapBase<T>::empty(const std::list<RangeMapBase>& rlist) {
+  bool RangeMapBase<T>::empty(const std::vector<RangeMapBase>& rlist) {
     // will not check the validation, the non-static method should check it
     if(rlist.empty()) return false; // empty child means it is a leaf range
                                     // the emptiness is then depends on the base range
@@ -374,14 +585,22 @@ namespace CppRange {
 
   // check whether 'lhs' is a subset of 'rhs'
   template<class T>
-  bool RangeMapBase<T>::subset(const std::list<RangeMapBase>& lhs_arg, 
-                               const std::list<RangeMapBase>& rhs_arg
+  bool RangeMapBase<T>::subset(const std::vector<RangeMapBase>& lhs_arg, 
+                               const std::vector<RangeMapBase>& rhs_arg
                                ) {
+    if(universal(rhs_arg)) return true;
+    if(wildcard(rhs_arg)) {
+      BOOST_FOREACH(const RangeMapBase& r, lhs_arg)
+        if(!subset(r.child, rhs_arg.front().child)) return false;
+      return true;
+    }
+    if(wildcard(lhs_arg)) return wild_subset(lhs_arg.front(), rhs_arg);
+    if(leaf(lhs_arg, rhs_arg)) return RangeSet<T>::subset(lhs_arg, rhs_arg);
     
-    std::list<RangeMapBase> lhs = lhs_arg;
-    std::list<RangeMapBase> rhs = rhs_arg;
+    std::vector<RangeMapBase> lhs = lhs_arg;
+    std::vector<RangeMapBase> rhs = rhs_arg;
 
-    typename std::list<RangeMapBase<T> >::iterator lit, rit;
+    typename std::vector<RangeMapBase<T> >::iterator lit, rit;
     for(lit = lhs.begin(), rit = rhs.begin();
         lit != lhs.end() && rit != rhs.end();
         ) {
@@ -397,7 +616,7 @@ namespace CppRange {
           return false;
         
         // the overlapped part
-        if(!subset(lit->child, rit->child))
+        if(!bound_subset(*lit, *rit) || !subset(lit->child, rit->child))
           return false;
         
         // check the lower part
@@ -428,11 +647,13 @@ namespace CppRange {
   }
 
   // check whether two range lists are equal
+  // equal lists have equal digests, so a different digest rejects them at once
   template<class T> inline
-  bool RangeMapBase<T>::equal(const std::list<RangeMapBase>& lhs_arg, 
-                              const std::list<RangeMapBase>& rhs_arg
+  bool RangeMapBase<T>::equal(const std::vector<RangeMapBase>& lhs_arg, 
+                              const std::vector<RangeMapBase>& rhs_arg
                               ) {
-    typename std::list<RangeMapBase>::const_iterator lit, rit;
+    if(list_digest(lhs_arg) != list_digest(rhs_arg)) return false;
+    typename std::vector<RangeMapBase>::const_iterator lit, rit;
     for(lit = lhs_arg.begin(), rit = rhs_arg.begin();
         lit != lhs_arg.end() && rit != rhs_arg.end();
         ++lit, ++rit) 
@@ -444,17 +665,71 @@ namespace CppRange {
       return true;
   }
 
+  // lexicographic order of the ranges from the highest one,
+  // a range is ordered by itself (RangeElement::less) and then by its children
+  // and a list is lower than the longer lists it begins
+  template<class T> inline
+  int RangeMapBase<T>::compare(const std::vector<RangeMapBase>& lhs,
+                               const std::vector<RangeMapBase>& rhs) {
+    typename std::vector<RangeMapBase>::const_iterator lit, rit;
+    for(lit = lhs.begin(), rit = rhs.begin(); lit != lhs.end() && rit != rhs.end(); ++lit, ++rit) {
+      if(!lit->RangeElement<T>::equal(*rit))
+        return lit->RangeElement<T>::less(*rit) ? -1 : 1;
+      int rv = compare(lit->child, rit->child);
+      if(rv) return rv;
+    }
+    if(lit != lhs.end()) return 1;
+    if(rit != rhs.end()) return -1;
+    return 0;
+  }
+
+  // check whether two range lists are overlapped
+  // a merge of the two lists, children are only visited when their hulls overlap
+  template<class T> inline
+  bool RangeMapBase<T>::overlap(const std::vector<RangeMapBase>& lhs, 
+                                const std::vector<RangeMapBase>& rhs) {
+    typename std::vector<RangeMapBase>::const_iterator lit, rit;
+    for(lit = lhs.begin(), rit = rhs.begin(); lit != lhs.end() && rit != rhs.end(); ) {
+      if(lit->RangeElement<T>::overlap(*rit)) {
+        if(lit->child.empty() || (bound_overlap(*lit, *rit) && overlap(lit->child, rit->child)))
+          return true;
+        if(lit->lower() < rit->lower()) ++rit;
+        else                            ++lit;
+      } else {
+        if(lit->upper() < rit->lower()) ++rit;
+        else                            ++lit;
+      }
+    }
+    return false;
+  }
+
   // combine two child lists
   template<class T> inline
-  std::list<RangeMapBase<T> > 
-  RangeMapBase<T>::combine (const std::list<RangeMapBase>& lhs_arg, 
-                            const std::list<RangeMapBase>& rhs_arg
+  std::vector<RangeMapBase<T> > 
+  RangeMapBase<T>::combine (const std::vector<RangeMapBase>& lhs_arg, 
+                            const std::vector<RangeMapBase>& rhs_arg
                             ) {
-    std::list<RangeMapBase> lhs = lhs_arg;
-    std::list<RangeMapBase> rhs = rhs_arg;
-    std::list<RangeMapBase> rv;
+    std::vector<RangeMapBase> rv;
+    if(universal(lhs_arg)) return lhs_arg;
+    if(universal(rhs_arg)) return rhs_arg;
+    if(wildcard(lhs_arg)) return wild(lhs_arg.front(), rhs_arg, wild_combine);
+    if(wildcard(rhs_arg)) return wild(rhs_arg.front(), lhs_arg, wild_combine);
+    if(leaf(lhs_arg, rhs_arg)) {
+      RangeBitmap<T> lb, rb;
+      if(dense(lhs_arg, rhs_arg, lb, rb)) lb.combine(rb).toList(rv);
+      else                                RangeSet<T>::combine(lhs_arg, rhs_arg, rv);
+      accumulate(rv);
+      return rv;
+    }
+
+    RangeMapCache<T>* cache = RangeMapCache<T>::cacheable(lhs_arg, rhs_arg) ?
+      RangeMapCache<T>::active() : NULL;
+    if(cache && cache->find(RangeMapCache<T>::op_combine, lhs_arg, rhs_arg, rv)) return rv;
+
+    std::vector<RangeMapBase> lhs = lhs_arg;
+    std::vector<RangeMapBase> rhs = rhs_arg;
       
-    typename std::list<RangeMapBase<T> >::iterator lit, rit;
+    typename std::vector<RangeMapBase<T> >::iterator lit, rit;
     for(lit = lhs.begin(), rit = rhs.begin();
         lit != lhs.end() && rit != rhs.end();
         ) {
@@ -488,42 +763,75 @@ namespace CppRange {
     }
     
     // push the rest
-    if(lit != lhs.end()) rv.splice(rv.end(), lhs, lit, lhs.end());
-    if(rit != rhs.end()) rv.splice(rv.end(), rhs, rit, rhs.end());
+    rv.insert(rv.end(), lit, lhs.end());
+    rv.insert(rv.end(), rit, rhs.end());
     
     normalize(rv);
+    if(cache) cache->insert(RangeMapCache<T>::op_combine, lhs_arg, rhs_arg, rv);
     return rv;
   }
 
 
   // get the intersection of two ranges
   template<class T> inline
-  std::list<RangeMapBase<T> >
-  RangeMapBase<T>::intersection(const std::list<RangeMapBase>& lhs_arg, 
-                                const std::list<RangeMapBase>& rhs_arg) {
-    std::list<RangeMapBase> rv;
-    
+  std::vector<RangeMapBase<T> >
+  RangeMapBase<T>::intersection(const std::vector<RangeMapBase>& lhs_arg, 
+                                const std::vector<RangeMapBase>& rhs_arg) {
+    std::vector<RangeMapBase> rv;
+    if(universal(lhs_arg)) return rhs_arg;
+    if(universal(rhs_arg)) return lhs_arg;
+    if(wildcard(lhs_arg)) return wild(lhs_arg.front(), rhs_arg, wild_intersection);
+    if(wildcard(rhs_arg)) return wild(rhs_arg.front(), lhs_arg, wild_intersection);
+    if(leaf(lhs_arg, rhs_arg)) {
+      RangeBitmap<T> lb, rb;
+      if(dense(lhs_arg, rhs_arg, lb, rb)) lb.intersection(rb).toList(rv);
+      else                                RangeSet<T>::intersection(lhs_arg, rhs_arg, rv);
+      accumulate(rv);
+      return rv;
+    }
+
+    RangeMapCache<T>* cache = RangeMapCache<T>::cacheable(lhs_arg, rhs_arg) ?
+      RangeMapCache<T>::active() : NULL;
+    if(cache && cache->find(RangeMapCache<T>::op_intersection, lhs_arg, rhs_arg, rv)) return rv;
+
     BOOST_FOREACH(const RangeMapBase<T>& cl, lhs_arg) {
       BOOST_FOREACH(const RangeMapBase<T>& cr, rhs_arg) {
+        if(cr.upper() < cl.lower()) break;        // lower ranges are all out of reach
+        if(cl.upper() < cr.lower() || !bound_overlap(cl, cr)) continue;
         RangeMapBase<T> result(cl.intersection(cr));
         if(!result.empty()) rv.push_back(result);
       }
     }
     normalize(rv);
+    if(cache) cache->insert(RangeMapCache<T>::op_intersection, lhs_arg, rhs_arg, rv);
     return rv;
   }
 
   // reduce the content of a range list (rhs) from another (lhs)
   template<class T> inline
-  std::list<RangeMapBase<T> >
-  RangeMapBase<T>::complement(const std::list<RangeMapBase>& lhs_arg, 
-                              const std::list<RangeMapBase>& rhs_arg) {
-      
-    std::list<RangeMapBase> lhs = lhs_arg;
-    std::list<RangeMapBase> rhs = rhs_arg;
-    std::list<RangeMapBase> rv;
+  std::vector<RangeMapBase<T> >
+  RangeMapBase<T>::complement(const std::vector<RangeMapBase>& lhs_arg, 
+                              const std::vector<RangeMapBase>& rhs_arg) {
+    std::vector<RangeMapBase> rv;
+    if(universal(rhs_arg)) return rv;
+    if(wildcard(lhs_arg)) return wild(lhs_arg.front(), rhs_arg, wild_complement);
+    if(wildcard(rhs_arg)) return wild(rhs_arg.front(), lhs_arg, complement_wild);
+    if(leaf(lhs_arg, rhs_arg)) {
+      RangeBitmap<T> lb, rb;
+      if(dense(lhs_arg, rhs_arg, lb, rb)) lb.complement(rb).toList(rv);
+      else                                RangeSet<T>::complement(lhs_arg, rhs_arg, rv);
+      accumulate(rv);
+      return rv;
+    }
+
+    RangeMapCache<T>* cache = RangeMapCache<T>::cacheable(lhs_arg, rhs_arg) ?
+      RangeMapCache<T>::active() : NULL;
+    if(cache && cache->find(RangeMapCache<T>::op_complement, lhs_arg, rhs_arg, rv)) return rv;
+
+    std::vector<RangeMapBase> lhs = lhs_arg;
+    std::vector<RangeMapBase> rhs = rhs_arg;
     
-    typename std::list<RangeMapBase<T> >::iterator lit, rit;
+    typename std::vector<RangeMapBase<T> >::iterator lit, rit;
     for(lit = lhs.begin(), rit = rhs.begin();
         lit != lhs.end() && rit != rhs.end();
         ) {
@@ -541,7 +849,7 @@ namespace CppRange {
         // the two ranges are overlapped
         if(!lit->child.empty()) {
           RangeMapBase mM(rM, complement(lit->child, rit->child));
-          if(lit->level == mM.level) rv.push_back(mM); // avoid empty range
+          if(!mM.child.empty()) rv.push_back(mM); // avoid empty range
         }
         
         if(!rL.empty()) {
@@ -564,96 +872,557 @@ namespace CppRange {
     }
     
     // push the rest
-    if(lit != lhs.end()) rv.splice(rv.end(), lhs, lit, lhs.end());
+    rv.insert(rv.end(), lit, lhs.end());
 
     normalize(rv);
+    if(cache) cache->insert(RangeMapCache<T>::op_complement, lhs_arg, rhs_arg, rv);
     return rv;
   }
   
   // normalize the range list
   // remove empty range and combine sub-ranges with equal sub trees
   template<class T> inline
-  void RangeMapBase<T>::normalize (std::list<RangeMapBase>& rlist) {
-    if(rlist.empty()) return;
-
+  void RangeMapBase<T>::normalize (std::vector<RangeMapBase>& rlist) {
     // it is assumed that all sub-ranges are not overlapped and in weak order
-    typename std::list<RangeMapBase>::iterator it, nt;
-    nt = rlist.begin();
-    it = nt++;
-
-    while(nt != rlist.end()) {
-      if(it->empty()) {         // remove empty it range
-        rlist.erase(it);
-        it = nt++;
-      } else if(nt->empty()) {
-        nt = rlist.erase(nt);   // remove empty nt range
-      } else if(it->RangeElement<T>::connected(*nt) && equal(it->child, nt->child)) {
+    // kept ranges are compacted to the front of the list, 'it' is the last kept one
+    typename std::vector<RangeMapBase>::iterator it, nt;
+    it = rlist.end();
+
+    for(nt = rlist.begin(); nt != rlist.end(); ++nt) {
+      if(nt->empty()) {
+        continue;               // remove empty nt range
+      } else if(it != rlist.end() && 
+                it->RangeElement<T>::connected(*nt) && equal(it->child, nt->child)) {
         it->lower(nt->lower()); // combine nt and it as they have the same sub-tree
-        nt = rlist.erase(nt);
       } else {
-        it = nt++;
+        it = (it == rlist.end()) ? rlist.begin() : it + 1;
+        if(it != nt) std::swap(*it, *nt);
       }
     }
     
-    if(it->empty()) rlist.erase(it);
+    rlist.erase(it == rlist.end() ? rlist.begin() : it + 1, rlist.end());
+    accumulate(rlist);
   }
 
   template<class T> inline
-  void RangeMapBase<T>::add_child(std::list<RangeMapBase>& rlist, const RangeMapBase& r) {
-    std::list<RangeMapBase> rv;
+  void RangeMapBase<T>::add_child(std::vector<RangeMapBase>& rlist, const RangeMapBase& r) {
+    std::vector<RangeMapBase> rv;
     RangeMapBase mr = r;
     
-    typename std::list<RangeMapBase<T> >::iterator lit;
+    typename std::vector<RangeMapBase<T> >::iterator lit;
     for(lit = rlist.begin(); lit != rlist.end(); ) {
       // using the standard combine function
       RangeMapBase rH, rM, rL;
       boost::tie(rH, rM, rL) = lit->combine(mr);
       
       // check result
-      if(!rH.empty()) rlist.insert(lit, rH);
       if(!rM.empty()) {
         // the two ranges are overlapped
-        rlist.insert(lit, rM);
+        if(!rH.empty()) rv.push_back(rH);
+        rv.push_back(rM);
+        ++lit;
         
-        if(!rL.empty()) {
-          if(rL.RangeElement<T>::subset(*lit)) {
-            // the lower part belongs to lit, insertion finished
-            mr = RangeMapBase();
-            *lit = rL;
-            break;
-          } else {
-            // otherwise lit proceeds and mr recounts
-            lit = rlist.erase(lit);
-            mr = rL;
-          }
+        if(!rL.empty() && !rL.RangeElement<T>::subset(*(lit-1))) {
+          // the lower part belongs to mr, lit proceeds and mr recounts
+          mr = rL;
         } else {
-          // rL empty also means finished
+          // the lower part belongs to lit or is empty, insertion finished
+          if(!rL.empty()) rv.push_back(rL);
           mr = RangeMapBase();
-          lit = rlist.erase(lit);
           break;
         }
       } else {
         // the two ranges are disjunctive
         if(rL.RangeElement<T>::subset(*lit)) {
-          // mr already inserted
-          mr = RangeMapBase();
+          // mr is higher than lit
           break;
-        } else
+        } else {
+          // lit is higher than mr
+          rv.push_back(*lit);
           ++lit;
+        }
       }
     }
     
     // push the rest
-    if(!mr.empty()) rlist.insert(lit, mr);
+    if(!mr.empty()) rv.push_back(mr);
+    rv.insert(rv.end(), lit, rlist.end());
     
+    rlist.swap(rv);
     normalize(rlist);
   }
 
+  // ? the cached hulls of two ranges are overlapped in every lower dimension
+  template<class T> inline
+  bool RangeMapBase<T>::bound_overlap(const RangeMapBase& lhs, const RangeMapBase& rhs) {
+    for(unsigned int i=0; i<lhs.bound_dimension() && i<rhs.bound_dimension(); i++) {
+      RangeElement<T> lb = lhs.bound_at(i), rb = rhs.bound_at(i);
+      if(lb.upper() < rb.lower() || rb.upper() < lb.lower())
+        return false;
+    }
+    return true;
+  }
+
+  // ? the cached hull of lhs is inside the cached hull of rhs in every lower dimension
+  template<class T> inline
+  bool RangeMapBase<T>::bound_subset(const RangeMapBase& lhs, const RangeMapBase& rhs) {
+    for(unsigned int i=0; i<lhs.bound_dimension() && i<rhs.bound_dimension(); i++) {
+      RangeElement<T> lb = lhs.bound_at(i), rb = rhs.bound_at(i);
+      if(rb.upper() < lb.upper() || lb.lower() < rb.lower())
+        return false;
+    }
+    return true;
+  }
+
+  // lists of leaf ranges are operated by the flat merges of RangeSet
+  template<class T> inline
+  bool RangeMapBase<T>::leaf(const std::vector<RangeMapBase>& lhs,
+                             const std::vector<RangeMapBase>& rhs) {
+    return (lhs.empty() || lhs.front().child.empty()) && (rhs.empty() || rhs.front().child.empty());
+  }
+
+  template<class T> inline
+  bool RangeMapBase<T>::wildcard(const std::vector<RangeMapBase>& rlist) {
+    return rlist.size() == 1 && rlist.front().full();
+  }
+
+  // a universal list holds every point, so it absorbs a union and is
+  // neutral to an intersection
+  template<class T> inline
+  bool RangeMapBase<T>::universal(const std::vector<RangeMapBase>& rlist) {
+    return wildcard(rlist) && (rlist.front().child.empty() || universal(rlist.front().child));
+  }
+
+  // the wildcard w is treated symbolically: every range of rlist is operated
+  // with the child of w, and the gaps of rlist are filled with the child of w
+  // when the result covers them (w | rlist, w - rlist)
+  // no arithmetic is done on the bounds of w so the limits of the domain
+  // never overflow
+  template<class T>
+  std::vector<RangeMapBase<T> >
+  RangeMapBase<T>::wild(const RangeMapBase& w, const std::vector<RangeMapBase>& rlist, wild_op op) {
+    std::vector<RangeMapBase> rv;
+    bool gaps = op == wild_combine || op == wild_complement;
+    bool open = true;                   // some values below 'top' are not visited
+    T top = full_upper<T>();
+    BOOST_FOREACH(const RangeMapBase& r, rlist) {
+      if(gaps && open && r.upper() < top)
+        append(rv, RangeMapBase(RangeElement<T>(top, r.upper() + min_unit<T>()), w.child));
+      if(w.child.empty()) {             // leaf ranges
+        if(op == wild_combine || op == wild_intersection) append(rv, r);
+      } else {
+        std::vector<RangeMapBase> c;
+        switch(op) {
+        case wild_combine:      c = combine(w.child, r.child);      break;
+        case wild_intersection: c = intersection(w.child, r.child); break;
+        case wild_complement:   c = complement(w.child, r.child);   break;
+        case complement_wild:   c = complement(r.child, w.child);   break;
+        }
+        if(!c.empty()) append(rv, RangeMapBase(r, c));
+      }
+      if(r.lower() == full_lower<T>()) open = false;
+      else                             top = r.lower() - min_unit<T>();
+    }
+    if(gaps && open)
+      append(rv, RangeMapBase(RangeElement<T>(top, full_lower<T>()), w.child));
+    accumulate(rv);
+    return rv;
+  }
+
+  // the ranges of rlist must cover the whole domain without a gap
+  template<class T> inline
+  bool RangeMapBase<T>::wild_subset(const RangeMapBase& w, const std::vector<RangeMapBase>& rlist) {
+    T top = full_upper<T>();
+    BOOST_FOREACH(const RangeMapBase& r, rlist) {
+      if(r.upper() != top || !subset(w.child, r.child)) return false;
+      if(r.lower() == full_lower<T>()) return true;
+      top = r.lower() - min_unit<T>();
+    }
+    return false;
+  }
+
+  // a range connected to the last one of the list with an equal child list
+  // is merged into it, the caller accumulates the list afterwards
+  template<class T> inline
+  void RangeMapBase<T>::append(std::vector<RangeMapBase>& rlist, const RangeMapBase& r) {
+    if(!rlist.empty() && r.upper() + min_unit<T>() == rlist.back().lower() &&
+       equal(rlist.back().child, r.child))
+      rlist.back().lower(r.lower());
+    else
+      rlist.push_back(r);
+  }
+
+  // two lists of leaf ranges sharing a narrow window are operated as bitmaps
+  // when a word of the bitmap holds at least one of their ranges on average
+  template<class T> inline
+  bool RangeMapBase<T>::dense(const std::vector<RangeMapBase>& lhs,
+                              const std::vector<RangeMapBase>& rhs,
+                              RangeBitmap<T>& lb, RangeBitmap<T>& rb) {
+    if(lhs.empty() || rhs.empty()) return false;
+    T rh = std::max(lhs.front().upper(), rhs.front().upper());
+    T rl = std::min(lhs.back().lower(), rhs.back().lower());
+    if(!RangeBitmap<T>::fit(rh, rl, lhs.size() + rhs.size())) return false;
+    lb = RangeBitmap<T>(rh, rl, lhs.begin(), lhs.end());
+    rb = RangeBitmap<T>(rh, rl, rhs.begin(), rhs.end());
+    return true;
+  }
+
+  // find the range holding v by binary search
+  // a range list is ordered from high to low, so the only candidate is
+  // the first range whose lower bound is not larger than v
+  template<class T> inline
+  const RangeMapBase<T>* RangeMapBase<T>::find(const std::vector<RangeMapBase>& rlist, const T& v) {
+    unsigned int first = 0, last = rlist.size();
+    while(first < last) {
+      unsigned int mid = (first + last) / 2;
+      if(rlist[mid].lower() > v) first = mid + 1;
+      else                       last = mid;
+    }
+    if(first == rlist.size() || rlist[first].upper() < v) return NULL;
+    return &rlist[first];
+  }
+
+  // update the cached sizes and digests from the lowest range
+  // the child lists are supposed to be up to date
+  template<class T> inline
+  void RangeMapBase<T>::accumulate(std::vector<RangeMapBase>& rlist) {
+    T acc(0);
+    boost::uint64_t d = 0;
+    for(typename std::vector<RangeMapBase<T> >::reverse_iterator it = rlist.rbegin();
+        it != rlist.rend(); ++it) {
+      acc = size_add(acc, it->size());
+      it->accum = acc;
+      d = mix(it->node_digest(), d);
+      it->digest = d;
+    }
+  }
+
+  // the number of points of a range list lower than a point in lexicographic order
+  template<class T> inline
+  T RangeMapBase<T>::rank(const std::vector<RangeMapBase>& rlist, const T* point) {
+    // the first range whose lower bound is not larger than point[0]
+    unsigned int first = 0, last = rlist.size();
+    while(first < last) {
+      unsigned int mid = (first + last) / 2;
+      if(rlist[mid].lower() > *point) first = mid + 1;
+      else                            last = mid;
+    }
+    if(first == rlist.size()) return T(0);
+
+    const RangeMapBase& b = rlist[first];
+    if(b.upper() < *point) return b.accum;       // the point is in a gap
+    T rv = b.accum - b.size();                   // all lower ranges
+    T offset = b.lower() < *point ? size_span(*point - min_unit<T>(), b.lower()) : T(0);
+    if(b.child.empty()) return size_add(rv, offset);
+    return size_add(size_add(rv, size_mul(offset, size(b.child))), rank(b.child, point + 1));
+  }
+
+  // get the k-th (from 0) point of a range list in lexicographic order
+  // k should be smaller than the size of the list
+  template<class T> inline
+  void RangeMapBase<T>::select(const std::vector<RangeMapBase>& rlist, T k, T* point) {
+    // the last range whose cached size is larger than k
+    unsigned int first = 0, last = rlist.size();
+    while(first < last) {
+      unsigned int mid = (first + last) / 2;
+      if(rlist[mid].accum > k) first = mid + 1;
+      else                     last = mid;
+    }
+
+    const RangeMapBase& b = rlist[first - 1];
+    k = k - (b.accum - b.size());                // offset in b
+    if(b.child.empty()) {
+      *point = b.lower() + k;
+    } else {
+      T csize = size(b.child);
+      *point = b.lower() + k / csize;
+      select(b.child, k % csize, point + 1);
+    }
+  }
+
+  // find a free box of size 'extent' in 'within' avoiding all ranges in 'lists'
+  // l is the current dimension and the lower corner is written to corner[0..d-l-1]
+  // the lowest free lower bound is either the lower bound of the window or right
+  // above a range, as moving a box upward only reduces the ranges it overlaps,
+  // so only these candidates are checked
+  // best fit: choose the candidate leaving the smallest gap to the next higher
+  // range of this dimension, each dimension is chosen greedily
+  template<class T> inline
+  bool RangeMapBase<T>::find_free(const std::vector<const std::vector<RangeMapBase>*>& lists,
+                                  const T* extent, const Range<T>& within, unsigned int l,
+                                  bool best, T* corner) {
+    std::vector<T> cands(1, within[l].lower());
+    BOOST_FOREACH(const std::vector<RangeMapBase>* rlist, lists) {
+      BOOST_FOREACH(const RangeMapBase& b, *rlist)
+        if(!(b.upper() < within[l].lower()) && !is_largest(b.upper()))
+          cands.push_back(b.upper() + min_unit<T>());
+    }
+    std::sort(cands.begin(), cands.end());
+    cands.erase(std::unique(cands.begin(), cands.end()), cands.end());
+
+    bool found = false;
+    T best_gap(0);
+    std::vector<T> sub(within.dimension() - l);     // the corner of a candidate
+    BOOST_FOREACH(const T& x, cands) {
+      // the box must fit below the window, so its upper bound never overflows
+      if(within[l].upper() < x || size_span(within[l].upper(), x) < extent[l]) break;
+      T xh = x + (extent[l] - min_unit<T>());
+
+      // collect the ranges overlapped with [xh:x]
+      // a gap is the number of free values above the box, saturated
+      std::vector<const std::vector<RangeMapBase>*> clists;
+      bool blocked = false;
+      T gap = xh < within[l].upper() ? size_span(within[l].upper(), xh + min_unit<T>()) : T(0);
+      BOOST_FOREACH(const std::vector<RangeMapBase>* rlist, lists) {
+        // the first range whose lower bound is not larger than xh
+        unsigned int first = 0, last = rlist->size();
+        while(first < last) {
+          unsigned int mid = (first + last) / 2;
+          if((*rlist)[mid].lower() > xh) first = mid + 1;
+          else                           last = mid;
+        }
+        if(first > 0) {
+          const T& nl = (*rlist)[first-1].lower();      // above xh
+          T ngap = separated(xh, nl) ? size_span(nl - min_unit<T>(), xh + min_unit<T>()) : T(0);
+          if(ngap < gap) gap = ngap;
+        }
+        for(; first < rlist->size() && !((*rlist)[first].upper() < x); ++first) {
+          if((*rlist)[first].child.empty()) { blocked = true; break; }
+          clists.push_back(&((*rlist)[first].child));
+        }
+        if(blocked) break;
+      }
+      if(blocked || (found && !(gap < best_gap))) continue;
+
+      sub[0] = x;
+      if(l + 1 < within.dimension() &&
+         !find_free(clists, extent, within, l + 1, best, &sub[1]))
+        continue;
+
+      std::copy(sub.begin(), sub.end(), corner);
+      if(!best) return true;
+      found = true;
+      best_gap = gap;
+    }
+    return found;
+  }
+
+  // check a batch of points against a range list, l is the coordinate of this level
+  // points are sorted on coordinate l (unless already sorted) and merged with
+  // the range list from low to high, the points falling in the same range
+  // are then checked against its child list together
+  template<class T> inline
+  void RangeMapBase<T>::contains(const std::vector<RangeMapBase>& rlist,
+                                 typename std::vector<point_ref>::iterator first,
+                                 typename std::vector<point_ref>::iterator last,
+                                 unsigned int l, std::vector<bool>& result) {
+    point_less cmp(l);
+    for(typename std::vector<point_ref>::iterator pit = first; pit != last && pit+1 != last; ++pit) {
+      if(cmp(*(pit+1), *pit)) {
+        std::sort(first, last, cmp);
+        break;
+      }
+    }
+
+    typename std::vector<RangeMapBase<T> >::const_reverse_iterator it = rlist.rbegin();
+    while(first != last && it != rlist.rend()) {
+      if(it->upper() < first->first[l]) { ++it; continue; }
+      if(first->first[l] < it->lower()) { ++first; continue; }
+
+      // all points in [first, next) belong to *it
+      typename std::vector<point_ref>::iterator next = first;
+      while(next != last && !(it->upper() < next->first[l])) ++next;
+      if(it->child.empty()) {
+        for(; first != next; ++first)
+          result[first->second] = true;
+      } else {
+        contains(it->child, first, next, l+1, result);
+        first = next;
+      }
+      ++it;
+    }
+  }
+
+  // a point of a universe is the bit of its row-major offset,
+  // the lowest point is bit 0 and the last dimension changes the fastest
+  template<class T> template<class S> inline
+  S RangeMapBase<T>::strides(const Range<T>& universe, std::vector<S>& stride) {
+    stride.assign(universe.dimension(), S(1));
+    if(universe.empty()) return S(0);
+    for(unsigned int l = universe.dimension() - 1; l > 0; l--)
+      stride[l-1] = stride[l] * static_cast<S>(universe[l].size());
+    return stride[0] * static_cast<S>(universe[0].size());
+  }
+
+  // the ranges are clipped to the universe, 'offset' is the bit of the lowest
+  // point of the block holding the list at level l
+  template<class T> inline
+  void RangeMapBase<T>::toBitmask(const std::vector<RangeMapBase>& rlist, const Range<T>& universe,
+                                  const std::size_t* stride, unsigned int l, std::size_t offset,
+                                  boost::uint64_t* w) {
+    const RangeElement<T>& u = universe[l];
+    BOOST_FOREACH(const RangeMapBase& r, rlist) {
+      if(r.upper() < u.lower()) break;          // lower ranges are all out of the universe
+      if(u.upper() < r.lower()) continue;
+      T rh = u.upper() < r.upper() ? u.upper() : r.upper();
+      T rl = r.lower() < u.lower() ? u.lower() : r.lower();
+      if(r.child.empty()) {                     // a run of bits
+        RangeBitmap<T>::set(w, offset + static_cast<std::size_t>(rl - u.lower()),
+                            offset + static_cast<std::size_t>(rh - u.lower()));
+      } else {
+        for(T v = rl; ; ++v) {
+          toBitmask(r.child, universe, stride, l+1,
+                    offset + static_cast<std::size_t>(v - u.lower()) * stride[l], w);
+          if(v == rh) break;
+        }
+      }
+    }
+  }
+
+  // empty blocks are skipped at word level and equal neighbouring
+  // sub-trees are merged on the way
+  template<class T> inline
+  std::vector<RangeMapBase<T> >
+  RangeMapBase<T>::fromBitmask(const boost::uint64_t* w, const Range<T>& universe,
+                               const std::size_t* stride, unsigned int l, std::size_t offset) {
+    std::vector<RangeMapBase> rv;
+    const RangeElement<T>& u = universe[l];
+    std::size_t end = offset + stride[l] * static_cast<std::size_t>(u.size());
+    if(RangeBitmap<T>::next(w, end, true, offset) == end) return rv;
+
+    if(l + 1 == universe.dimension()) {
+      RangeBitmap<T>::toList(w, offset, end, u.lower(), rv);
+    } else {
+      for(T v = u.upper(); ; --v) {
+        std::vector<RangeMapBase> c =
+          fromBitmask(w, universe, stride, l+1, offset + static_cast<std::size_t>(v - u.lower()) * stride[l]);
+        if(!c.empty()) {
+          if(!rv.empty() && rv.back().lower() == v + min_unit<T>() &&
+             list_digest(rv.back().child) == list_digest(c) && equal(rv.back().child, c)) {
+            rv.back().lower(v);
+          } else {
+            rv.push_back(RangeMapBase(v));
+            rv.back().child.swap(c);
+            rv.back().refresh();
+          }
+        }
+        if(v == u.lower()) break;
+      }
+    }
+    accumulate(rv);
+    return rv;
+  }
+
+  // the offsets are relative to the lowest point of the block and appended
+  // in ascending order, contiguous offsets of neighbouring rows are merged
+  // a child list covering its whole row is flattened once for all its rows
+  template<class T> inline
+  void RangeMapBase<T>::flatten(const std::vector<RangeMapBase>& rlist, const Range<T>& universe,
+                                const T* stride, unsigned int l, std::vector<RangeElement<T> >& rv) {
+    const RangeElement<T>& u = universe[l];
+    for(typename std::vector<RangeMapBase>::const_reverse_iterator it = rlist.rbegin();
+        it != rlist.rend(); ++it) {
+      if(u.upper() < it->lower()) break;        // higher ranges are all out of the universe
+      if(it->upper() < u.lower()) continue;
+      T rh = (u.upper() < it->upper() ? u.upper() : it->upper()) - u.lower();
+      T rl = (it->lower() < u.lower() ? u.lower() : it->lower()) - u.lower();
+
+      std::vector<RangeElement<T> > c;
+      if(it->child.empty())
+        c.push_back(RangeElement<T>(rh, rl));
+      else
+        flatten(it->child, universe, stride, l+1, c);
+      if(c.empty()) continue;
+
+      if(it->child.empty() ||
+         (c.size() == 1 && c.front().lower() == T(0) && c.front().upper() == stride[l] - min_unit<T>())) {
+        c.front() = RangeElement<T>((rh - rl + min_unit<T>()) * stride[l] - min_unit<T>(), T(0));
+        rh = rl;                                // all rows in one run
+      }
+      for(T v = rl; ; ++v) {
+        BOOST_FOREACH(const RangeElement<T>& r, c) {
+          T lo = v * stride[l] + r.lower(), hi = v * stride[l] + r.upper();
+          if(!rv.empty() && rv.back().upper() + min_unit<T>() == lo) rv.back().upper(hi);
+          else                                                       rv.push_back(RangeElement<T>(hi, lo));
+        }
+        if(v == rh) break;
+      }
+    }
+  }
+
+  // the offsets are ascending and relative to the lowest point of the block,
+  // a run of whole rows becomes a single range and a partial row is built
+  // from the offsets inside it, equal neighbouring rows are merged
+  template<class T> inline
+  std::vector<RangeMapBase<T> >
+  RangeMapBase<T>::unflatten(const std::vector<RangeElement<T> >& offsets, const Range<T>& universe,
+                             const T* stride, unsigned int l) {
+    std::vector<RangeMapBase> rv;
+    const RangeElement<T>& u = universe[l];
+    if(l + 1 == universe.dimension()) {
+      for(std::size_t i = offsets.size(); i > 0; i--)
+        rv.push_back(RangeMapBase(u.lower() + offsets[i-1].upper(), u.lower() + offsets[i-1].lower()));
+      accumulate(rv);
+      return rv;
+    }
+
+    const T s = stride[l];
+    std::vector<RangeMapBase> full;             // the child list of a whole row
+    std::size_t i = 0;
+    T lo = offsets.empty() ? T(0) : offsets.front().lower();
+    while(i < offsets.size()) {
+      T hi = offsets[i].upper();
+      T vl = lo / s, vh = vl;
+      std::vector<RangeMapBase> c;
+      if(lo % s == T(0) && !(hi - lo + min_unit<T>() < s)) {
+        // whole rows
+        vh = (hi + min_unit<T>()) / s - min_unit<T>();
+        if(full.empty()) {
+          Range<T> row;
+          for(unsigned int k = l + 1; k < universe.dimension(); k++) row.add_lower(universe[k]);
+          full.push_back(RangeMapBase(row));
+          accumulate(full);
+        }
+        c = full;
+        lo = (vh + min_unit<T>()) * s;
+        if(hi < lo && ++i < offsets.size()) lo = offsets[i].lower();
+      } else {
+        // a partial row
+        T base = vl * s, end = base + s;
+        std::vector<RangeElement<T> > part;
+        while(i < offsets.size() && lo < end) {
+          hi = offsets[i].upper();
+          if(hi < end) {
+            part.push_back(RangeElement<T>(hi - base, lo - base));
+            if(++i < offsets.size()) lo = offsets[i].lower();
+          } else {
+            part.push_back(RangeElement<T>(end - min_unit<T>() - base, lo - base));
+            lo = end;
+            break;
+          }
+        }
+        c = unflatten(part, universe, stride, l+1);
+      }
+
+      T rl = u.lower() + vl, rh = u.lower() + vh;
+      if(!rv.empty() && rv.back().upper() + min_unit<T>() == rl && equal(rv.back().child, c)) {
+        rv.back().upper(rh);
+      } else {
+        rv.push_back(RangeMapBase(rh, rl));
+        rv.back().child.swap(c);
+        rv.back().refresh();
+      }
+    }
+    std::reverse(rv.begin(), rv.end());
+    accumulate(rv);
+    return rv;
+  }
+
   // convert to a list of ranges
   template<class T> inline
-  std::list<Range<T> > RangeMapBase<T>::toRange(const std::list<RangeMapBase>& rlist) {
+  std::list<Range<T> > RangeMapBase<T>::toRange(const std::vector<RangeMapBase>& rlist) {
     std::list<Range<T> > rv;
-    for(typename std::list<RangeMapBase<T> >::const_iterator it = rlist.begin();
+    for(typename std::vector<RangeMapBase<T> >::const_iterator it = rlist.begin();
         it != rlist.end(); ++it) {
       std::list<Range<T> > slist = it->toRange();
       rv.insert(rv.end(), slist.begin(), slist.end());
@@ -663,12 +1432,12 @@ namespace CppRange {
 
   // convert to string
   template<class T> inline
-  std::string RangeMapBase<T>::toString(const std::list<RangeMapBase>& rlist, bool compress) {
+  std::string RangeMapBase<T>::toString(const std::vector<RangeMapBase>& rlist, bool compress) {
     std::string rv;
     if(!rlist.empty()) {
       if(rlist.size() > 1) {  // more than one sub-ranges
         rv += "{";
-        for(typename std::list<RangeMapBase<T> >::const_iterator it = rlist.begin();
+        for(typename std::vector<RangeMapBase<T> >::const_iterator it = rlist.begin();
             it != rlist.end(); ) {
           rv += it->toString(compress);
           ++it;
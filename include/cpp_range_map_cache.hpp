@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * Operation cache (computed table) of RangeMap
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_MAP_CACHE_H_
+#define _CPP_RANGE_MAP_CACHE_H_
+
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#include "cpp_range_map_base.hpp"
+
+// the default number of entries in an operation cache
+#ifndef CPP_RANGE_CACHE_SIZE
+#define CPP_RANGE_CACHE_SIZE 4096
+#endif
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeMapCache
+  //
+  // an opt-in cache of the results of combine(), intersection() and
+  // complement() on child lists, in the style of the computed table of
+  // decision diagrams
+  //
+  // a cache is active for all RangeMap<T> operations of the thread creating
+  // it, from its construction to its destruction, caches of the same type
+  // are stacked per thread and may be destroyed in any order
+  // the table is direct-mapped and keyed by the operation and the cached
+  // structural digests of the operands, a hit is confirmed by comparing the
+  // operands so a hash collision never returns a wrong result
+  // lists of leaf ranges are not cached as they are cheap to compute
+  //
+  // an entry holds deep copies of both operands and the result, and a hit
+  // costs an O(size) comparison of the operands plus a copy of the result,
+  // so the cache only pays off when a sub-result is much more expensive
+  // to compute than to copy
+  //
+  // with C++11 every thread has its own stack of active caches
+  // (thread_local), but a cache object is not thread safe: it must be used
+  // and destroyed only by the thread creating it
+  // before C++11 the stack is a plain static pointer, so caches must only
+  // be used in a single-threaded program
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeMapCache {
+  public:
+    enum operation {
+      op_combine,
+      op_intersection,
+      op_complement
+    };
+
+  private:
+    struct Entry {
+      bool used;
+      operation op;
+      std::vector<RangeMapBase<T> > lhs;
+      std::vector<RangeMapBase<T> > rhs;
+      std::vector<RangeMapBase<T> > result;
+      Entry() : used(false), op(op_combine) {}
+    };
+
+    std::vector<Entry> table;         // the computed table
+    RangeMapCache* previous;          // the cache active before this one
+    unsigned long hit_count;          // the number of hits
+    unsigned long miss_count;         // the number of misses
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    explicit RangeMapCache(unsigned int size = CPP_RANGE_CACHE_SIZE);
+                                                        // create and activate a cache
+                                                        // of at least 'size' entries
+    ~RangeMapCache();                                   // deactivate the cache
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    static RangeMapCache* active();                     // the active cache, NULL if none
+    static bool cacheable(const std::vector<RangeMapBase<T> >&,
+                          const std::vector<RangeMapBase<T> >&);
+                                                        // ? an operation is worth caching
+    bool find(operation, const std::vector<RangeMapBase<T> >&,
+              const std::vector<RangeMapBase<T> >&, std::vector<RangeMapBase<T> >&);
+                                                        // look up a result
+    void insert(operation, const std::vector<RangeMapBase<T> >&,
+                const std::vector<RangeMapBase<T> >&, const std::vector<RangeMapBase<T> >&);
+                                                        // store a result
+    void clear();                                       // remove all entries
+    unsigned long hits() const;                         // the number of hits
+    unsigned long misses() const;                       // the number of misses
+
+  private:
+    static RangeMapCache* current();                    // the active cache of this thread
+    static void current(RangeMapCache*);                // set the active cache of this thread
+    static RangeMapCache*& slot();                      // the pointer to the active cache
+    unsigned int index(operation, const std::vector<RangeMapBase<T> >&,
+                       const std::vector<RangeMapBase<T> >&) const;
+                                                        // the table entry of an operation
+
+    // not copyable
+    RangeMapCache(const RangeMapCache&);
+    RangeMapCache& operator= (const RangeMapCache&);
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+
+  // the size of the table is rounded up to a power of 2
+  template<class T> inline
+  RangeMapCache<T>::RangeMapCache(unsigned int size)
+    : previous(current()), hit_count(0), miss_count(0) {
+    unsigned int n = 1;
+    while(n < size) n <<= 1;
+    table.resize(n);
+    current(this);
+  }
+
+  // a cache below the top of the stack is unlinked from the cache above it
+  template<class T> inline
+  RangeMapCache<T>::~RangeMapCache() {
+    if(current() == this) {
+      current(previous);
+      return;
+    }
+    for(RangeMapCache* c = current(); c != NULL; c = c->previous)
+      if(c->previous == this) {
+        c->previous = previous;
+        return;
+      }
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  template<class T> inline
+  RangeMapCache<T>* RangeMapCache<T>::active() {
+    return current();
+  }
+
+  template<class T> inline
+  bool RangeMapCache<T>::cacheable(const std::vector<RangeMapBase<T> >& lhs,
+                                   const std::vector<RangeMapBase<T> >& rhs) {
+    return !lhs.empty() && !rhs.empty() && !lhs.front().child.empty();
+  }
+
+  template<class T> inline
+  bool RangeMapCache<T>::find(operation op, const std::vector<RangeMapBase<T> >& lhs,
+                              const std::vector<RangeMapBase<T> >& rhs,
+                              std::vector<RangeMapBase<T> >& result) {
+    const Entry& e = table[index(op, lhs, rhs)];
+    if(e.used && e.op == op &&
+       RangeMapBase<T>::list_digest(e.lhs) == RangeMapBase<T>::list_digest(lhs) &&
+       RangeMapBase<T>::list_digest(e.rhs) == RangeMapBase<T>::list_digest(rhs) &&
+       RangeMapBase<T>::equal(e.lhs, lhs) && RangeMapBase<T>::equal(e.rhs, rhs)) {
+      result = e.result;
+      ++hit_count;
+      return true;
+    }
+    ++miss_count;
+    return false;
+  }
+
+  // an older entry on the same slot is replaced
+  template<class T> inline
+  void RangeMapCache<T>::insert(operation op, const std::vector<RangeMapBase<T> >& lhs,
+                                const std::vector<RangeMapBase<T> >& rhs,
+                                const std::vector<RangeMapBase<T> >& result) {
+    Entry& e = table[index(op, lhs, rhs)];
+    e.used = true;
+    e.op = op;
+    e.lhs = lhs;
+    e.rhs = rhs;
+    e.result = result;
+  }
+
+  template<class T> inline
+  void RangeMapCache<T>::clear() {
+    unsigned int n = table.size();
+    table.clear();
+    table.resize(n);
+  }
+
+  template<class T> inline
+  unsigned long RangeMapCache<T>::hits() const {
+    return hit_count;
+  }
+
+  template<class T> inline
+  unsigned long RangeMapCache<T>::misses() const {
+    return miss_count;
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  // one pointer per thread with C++11, one per program before C++11
+  template<class T> inline
+  RangeMapCache<T>*& RangeMapCache<T>::slot() {
+#if __cplusplus >= 201103L
+    thread_local RangeMapCache* cache = NULL;
+#else
+    static RangeMapCache* cache = NULL;
+#endif
+    return cache;
+  }
+
+  template<class T> inline
+  RangeMapCache<T>* RangeMapCache<T>::current() {
+    return slot();
+  }
+
+  template<class T> inline
+  void RangeMapCache<T>::current(RangeMapCache* cache) {
+    slot() = cache;
+  }
+
+  template<class T> inline
+  unsigned int RangeMapCache<T>::index(operation op, const std::vector<RangeMapBase<T> >& lhs,
+                                       const std::vector<RangeMapBase<T> >& rhs) const {
+    boost::uint64_t h = RangeMapBase<T>::mix(RangeMapBase<T>::list_digest(lhs), op);
+    h = RangeMapBase<T>::mix(h, RangeMapBase<T>::list_digest(rhs));
+    return h & (table.size() - 1);
+  }
+
+}
+
+#endif
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * Coordinate compression of a group of RangeMaps
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_MAP_COMPRESSOR_H_
+#define _CPP_RANGE_MAP_COMPRESSOR_H_
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <boost/foreach.hpp>
+
+#include "cpp_range_map.hpp"
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeMapCompressor
+  //
+  // the breakpoints of a group of RangeMaps in each dimension:
+  // the lower bound of every range and the value above its upper bound
+  // the breakpoints cut a dimension into elementary ranges which are
+  // never divided by a map of the group, so a map is compressed by
+  // replacing every bound with the rank of its elementary range
+  //
+  // the compressed maps have the same structure on small dense values,
+  // where fragmented lists are operated as bitmaps (RangeBitmap), and
+  // a compressed result is expanded back to the original values
+  // only integral domains are supported
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeMapCompressor {
+  private:
+    std::vector<std::vector<T> > cut;   // the sorted breakpoints of each dimension
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeMapCompressor();
+    template<class InputIterator>
+    RangeMapCompressor(InputIterator first, InputIterator last);
+                                                        // the breakpoints of a group of maps
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    void add(const RangeMap<T>&);                       // add the breakpoints of a map
+    unsigned int dimension() const;                     // the number of dimensions
+    std::size_t size(unsigned int) const;               // the number of elementary ranges
+                                                        // in a dimension
+    RangeMap<T> compress(const RangeMap<T>&) const;     // the map on the ranks of the
+                                                        // elementary ranges
+    RangeMap<T> expand(const RangeMap<T>&) const;       // the map of compressed ranks
+    RangeMap<T> combine(const RangeMap<T>&, const RangeMap<T>&) const;
+    RangeMap<T> intersection(const RangeMap<T>&, const RangeMap<T>&) const;
+    RangeMap<T> complement(const RangeMap<T>&, const RangeMap<T>&) const;
+                                                        // operations in the compressed space
+
+  private:
+    void collect(const std::vector<RangeMapBase<T> >&, unsigned int,
+                 std::vector<std::vector<T> >&) const;  // the breakpoints of a range list
+    bool convert(const std::vector<RangeMapBase<T> >&, unsigned int, bool,
+                 std::vector<RangeMapBase<T> >&) const; // compress or expand a range list
+    static bool top(const T&);                          // ? the largest value of a
+                                                        // bounded type
+    bool rank(unsigned int, const T&, std::size_t&) const;
+                                                        // the rank of a breakpoint not
+                                                        // lower than a known rank
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+  template<class T> inline
+  RangeMapCompressor<T>::RangeMapCompressor() {}
+
+  template<class T> template<class InputIterator> inline
+  RangeMapCompressor<T>::RangeMapCompressor(InputIterator first, InputIterator last) {
+    for(; first != last; ++first) add(*first);
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  // the new breakpoints are sorted and merged into the tables
+  template<class T> inline
+  void RangeMapCompressor<T>::add(const RangeMap<T>& r) {
+    if(!r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return;
+    }
+    if(r.empty()) return;
+    if(!cut.empty() && cut.size() != r.dimension()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_NonComparable(r.toString(), "a map compressor", "add()"));
+#endif
+      return;
+    }
+
+    std::vector<std::vector<T> > points(r.dimension());
+    collect(r.child, 0, points);
+    cut.resize(r.dimension());
+    for(unsigned int l = 0; l < cut.size(); l++) {
+      std::sort(points[l].begin(), points[l].end());
+      std::size_t middle = cut[l].size();
+      cut[l].insert(cut[l].end(), points[l].begin(),
+                    std::unique(points[l].begin(), points[l].end()));
+      std::inplace_merge(cut[l].begin(), cut[l].begin() + middle, cut[l].end());
+      cut[l].erase(std::unique(cut[l].begin(), cut[l].end()), cut[l].end());
+    }
+  }
+
+  template<class T> inline
+  unsigned int RangeMapCompressor<T>::dimension() const {
+    return cut.size();
+  }
+
+  template<class T> inline
+  std::size_t RangeMapCompressor<T>::size(unsigned int l) const {
+    return l < cut.size() ? cut[l].size() : 0;
+  }
+
+  // all bounds of the map must be breakpoints (the map is added beforehand)
+  template<class T> inline
+  RangeMap<T> RangeMapCompressor<T>::compress(const RangeMap<T>& r) const {
+    std::vector<RangeMapBase<T> > rv;
+    if(!r.valid() || (!r.empty() && r.dimension() != cut.size()) || !convert(r.child, 0, true, rv)) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return RangeMap<T>();
+    }
+    return RangeMap<T>(rv);
+  }
+
+  template<class T> inline
+  RangeMap<T> RangeMapCompressor<T>::expand(const RangeMap<T>& r) const {
+    std::vector<RangeMapBase<T> > rv;
+    if(!r.valid() || (!r.empty() && r.dimension() != cut.size()) || !convert(r.child, 0, false, rv)) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return RangeMap<T>();
+    }
+    return RangeMap<T>(rv);
+  }
+
+  template<class T> inline
+  RangeMap<T> RangeMapCompressor<T>::combine(const RangeMap<T>& lhs, const RangeMap<T>& rhs) const {
+    return expand(compress(lhs).combine(compress(rhs)));
+  }
+
+  template<class T> inline
+  RangeMap<T> RangeMapCompressor<T>::intersection(const RangeMap<T>& lhs, const RangeMap<T>& rhs) const {
+    return expand(compress(lhs).intersection(compress(rhs)));
+  }
+
+  template<class T> inline
+  RangeMap<T> RangeMapCompressor<T>::complement(const RangeMap<T>& lhs, const RangeMap<T>& rhs) const {
+    return expand(compress(lhs).complement(compress(rhs)));
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  // no breakpoint above the largest value
+  template<class T> inline
+  void RangeMapCompressor<T>::collect(const std::vector<RangeMapBase<T> >& rlist, unsigned int l,
+                                      std::vector<std::vector<T> >& points) const {
+    BOOST_FOREACH(const RangeMapBase<T>& r, rlist) {
+      points[l].push_back(r.lower());
+      if(!top(r.upper()))
+        points[l].push_back(r.upper() + min_unit<T>());
+      collect(r.child, l+1, points);
+    }
+  }
+
+  // the rank of an elementary range is the index of its lower breakpoint,
+  // its upper bound is one below the next breakpoint (or the largest value),
+  // both mappings keep the order and the connection of ranges
+  // so a normalized list stays normalized
+  // nodes are built in place as copying a node copies its child list
+  template<class T> inline
+  bool RangeMapCompressor<T>::convert(const std::vector<RangeMapBase<T> >& rlist, unsigned int l,
+                                      bool to_rank, std::vector<RangeMapBase<T> >& rv) const {
+    rv.resize(rlist.size());
+    std::size_t pos = 0;
+    for(std::size_t i = rlist.size(); i-- > 0; ) {
+      const RangeMapBase<T>& r = rlist[i];
+      RangeMapBase<T>& n = rv[i];
+      T rh, rl;
+      if(to_rank) {
+        if(!rank(l, r.lower(), pos)) return false;
+        rl = T(pos);
+        if(top(r.upper()))
+          rh = T(cut[l].size() - 1);
+        else if(rank(l, r.upper() + min_unit<T>(), pos))
+          rh = T(pos) - min_unit<T>();
+        else
+          return false;
+      } else {
+        if(r.lower() < T(0) || !(static_cast<std::size_t>(r.upper()) < cut[l].size())) return false;
+        std::size_t kh = static_cast<std::size_t>(r.upper()), kl = static_cast<std::size_t>(r.lower());
+        rl = cut[l][kl];
+        rh = kh + 1 < cut[l].size() ? cut[l][kh+1] - min_unit<T>() : std::numeric_limits<T>::max();
+                                        // only reached by a bounded type
+      }
+      n.lower(rl);
+      n.upper(rh);
+      if(!r.child.empty()) {
+        if(!convert(r.child, l+1, to_rank, n.child)) return false;
+        n.refresh_bound();
+      }
+    }
+    RangeMapBase<T>::accumulate(rv);
+    return true;
+  }
+
+  // an unbounded type has no largest value, every range has a breakpoint above it
+  template<class T> inline
+  bool RangeMapCompressor<T>::top(const T& v) {
+    return std::numeric_limits<T>::is_bounded && v == std::numeric_limits<T>::max();
+  }
+
+  // ranges are converted from low to high so the search gallops from the
+  // last rank, a dense list then costs a few comparisons per bound
+  template<class T> inline
+  bool RangeMapCompressor<T>::rank(unsigned int l, const T& v, std::size_t& k) const {
+    const std::vector<T>& c = cut[l];
+    std::size_t first = k, step = 1;
+    while(first + step < c.size() && c[first + step] < v) {
+      first += step;
+      step *= 2;
+    }
+    typename std::vector<T>::const_iterator it =
+      std::lower_bound(c.begin() + first, c.begin() + std::min(first + step + 1, c.size()), v);
+    if(it == c.end() || *it != v) return false;
+    k = it - c.begin();
+    return true;
+  }
+
+}
+
+#endif
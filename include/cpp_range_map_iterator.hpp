@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * Lazy iterators over the range vectors and points of a RangeMap
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_MAP_ITERATOR_H_
+#define _CPP_RANGE_MAP_ITERATOR_H_
+
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+#include "cpp_range_map_base.hpp"
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeMapIterator
+  //
+  // walk the range vectors (boxes) of a RangeMap one by one
+  // optionally clipped to a window range
+  //
+  // the iterator keeps a cursor for every level of the current box, so it
+  // needs O(d) memory and no RangeMap is built for the window
+  // the current box is reused and only the levels moved by an increment
+  // are updated
+  // in a window, only the ranges overlapped with the window are visited
+  // and subtrees are skipped by their cached hulls
+  //
+  // an iterator is invalidated when the RangeMap is modified
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeMapIterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Range<T> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Range<T>* pointer;
+    typedef const Range<T>& reference;
+
+  private:
+    struct Cursor {
+      const RangeMapBase<T>* node;    // the current range of a level
+      const RangeMapBase<T>* last;    // the end of the range list
+    };
+
+    RangeSmallVector<Cursor, CPP_RANGE_INLINE_DIMENSION> stack;
+                                      // cursors from the top level
+    Range<T> window;                  // the window, no clip if empty
+    Range<T> box;                     // the current box
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeMapIterator() {}                               // the end iterator
+    explicit RangeMapIterator(const std::vector<RangeMapBase<T> >&,
+                              const Range<T>& w = Range<T>());
+                                                        // the first box of a range list
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    reference operator* () const;                       // the current box
+    pointer operator-> () const;
+    RangeMapIterator& operator++ ();                    // move to the next box
+    RangeMapIterator operator++ (int);
+    bool equal(const RangeMapIterator& r) const;        // ? two iterators are at the same box
+
+  private:
+    Cursor first(const std::vector<RangeMapBase<T> >&, unsigned int) const;
+                                                        // the first range in the window
+    bool bound_overlap(const RangeMapBase<T>&, unsigned int) const;
+                                                        // ? the hull of a range is in the window
+    void seek(unsigned int);                            // move to the next leaf in the window
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+
+  template<class T> inline
+  RangeMapIterator<T>::RangeMapIterator(const std::vector<RangeMapBase<T> >& rlist,
+                                        const Range<T>& w)
+    : window(w) {
+    if(rlist.empty()) return;
+    stack.push_back(first(rlist, 0));
+    seek(0);
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  template<class T> inline
+  typename RangeMapIterator<T>::reference RangeMapIterator<T>::operator* () const {
+    return box;
+  }
+
+  template<class T> inline
+  typename RangeMapIterator<T>::pointer RangeMapIterator<T>::operator-> () const {
+    return &box;
+  }
+
+  template<class T> inline
+  RangeMapIterator<T>& RangeMapIterator<T>::operator++ () {
+    ++stack.back().node;
+    seek(stack.size() - 1);
+    return *this;
+  }
+
+  template<class T> inline
+  RangeMapIterator<T> RangeMapIterator<T>::operator++ (int) {
+    RangeMapIterator rv(*this);
+    ++(*this);
+    return rv;
+  }
+
+  // every leaf range is a distinct node, so the leaf cursor identifies a box
+  template<class T> inline
+  bool RangeMapIterator<T>::equal(const RangeMapIterator& r) const {
+    if(stack.empty() || r.stack.empty()) return stack.empty() == r.stack.empty();
+    return stack.back().node == r.stack.back().node;
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  // ranges are stored from high to low, the first range in the window is
+  // the first one whose lower bound is not larger than the upper bound of the window
+  template<class T> inline
+  typename RangeMapIterator<T>::Cursor
+  RangeMapIterator<T>::first(const std::vector<RangeMapBase<T> >& rlist, unsigned int l) const {
+    unsigned int lo = 0, hi = rlist.size();
+    if(window.dimension()) {
+      while(lo < hi) {
+        unsigned int mid = (lo + hi) / 2;
+        if(rlist[mid].lower() > window[l].upper()) lo = mid + 1;
+        else                                       hi = mid;
+      }
+    }
+    Cursor rv;
+    rv.node = &rlist[0] + lo;
+    rv.last = &rlist[0] + rlist.size();
+    return rv;
+  }
+
+  template<class T> inline
+  bool RangeMapIterator<T>::bound_overlap(const RangeMapBase<T>& b, unsigned int l) const {
+    for(unsigned int i=0; i<b.bound_dimension(); i++) {
+      RangeElement<T> r = b.bound_at(i);
+      if(r.upper() < window[l+i+1].lower() || window[l+i+1].upper() < r.lower())
+        return false;
+    }
+    return true;
+  }
+
+  // depth-first search from the cursor on top of the stack
+  // the box is updated from the level 'from', the highest level moved
+  template<class T> inline
+  void RangeMapIterator<T>::seek(unsigned int from) {
+    while(!stack.empty()) {
+      Cursor& c = stack.back();
+      unsigned int l = stack.size() - 1;
+      if(c.node == c.last || (window.dimension() && c.node->upper() < window[l].lower())) {
+        // this level is exhausted
+        stack.pop_back();
+        if(!stack.empty()) {
+          ++stack.back().node;
+          if(from > stack.size() - 1) from = stack.size() - 1;
+        }
+      } else if(window.dimension() && !bound_overlap(*c.node, l)) {
+        ++c.node;
+      } else if(!c.node->child.empty()) {
+        stack.push_back(first(c.node->child, l+1));
+      } else {
+        break;                  // a leaf in the window
+      }
+    }
+
+    // update the current box, all leaves have the same depth
+    if(box.dimension() != stack.size()) {
+      box = Range<T>();
+      for(unsigned int i=0; i<stack.size(); i++)
+        box.add_lower(RangeElement<T>());
+      from = 0;
+    }
+    for(unsigned int i=from; i<stack.size(); i++) {
+      if(window.dimension())
+        box[i] = stack[i].node->RangeElement<T>::intersection(window[i]);
+      else
+        box[i] = *stack[i].node;
+    }
+  }
+
+  /////////////////////////////////////////////
+  // overload operators
+
+  template <class T>
+  inline bool operator== (const RangeMapIterator<T>& lhs, const RangeMapIterator<T>& rhs) {
+    return lhs.equal(rhs);
+  }
+
+  template <class T>
+  inline bool operator!= (const RangeMapIterator<T>& lhs, const RangeMapIterator<T>& rhs) {
+    return !lhs.equal(rhs);
+  }
+
+  //////////////////////////////////////////////////
+  // RangeMapPointIterator
+  //
+  // walk all points of a RangeMap in lexicographic (row-major) order,
+  // from the lowest value of the first dimension
+  //
+  // the points of the last dimension are grouped into runs: a run is
+  // the prefix point[0..d-2] with the last coordinate running from
+  // run_lower() to run_upper(), next_run() jumps over the rest of a run
+  //
+  // an iterator is invalidated when the RangeMap is modified
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeMapPointIterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::vector<T> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const std::vector<T>* pointer;
+    typedef const std::vector<T>& reference;
+
+  private:
+    struct Cursor {
+      const std::vector<RangeMapBase<T> >* rlist; // the range list of a level
+      unsigned int left;                          // ranges not yet visited, the current
+                                                  // range is (*rlist)[left-1]
+    };
+
+    RangeSmallVector<Cursor, CPP_RANGE_INLINE_DIMENSION> stack;
+                                      // cursors from the top level
+    std::vector<T> point;             // the current point
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeMapPointIterator() {}                          // the end iterator
+    explicit RangeMapPointIterator(const std::vector<RangeMapBase<T> >&);
+                                                        // the first point of a range list
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    reference operator* () const;                       // the current point
+    pointer operator-> () const;
+    RangeMapPointIterator& operator++ ();               // move to the next point
+    RangeMapPointIterator operator++ (int);
+    RangeMapPointIterator& next_run();                  // move to the first point of the next run
+    const T& run_lower() const;                         // the lowest last coordinate of the run
+    const T& run_upper() const;                         // the highest last coordinate of the run
+    bool equal(const RangeMapPointIterator& r) const;   // ? two iterators are at the same point
+
+  private:
+    const RangeMapBase<T>& node(const Cursor&) const;   // the current range of a cursor
+    void descend();                                     // move down to the first run
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+
+  template<class T> inline
+  RangeMapPointIterator<T>::RangeMapPointIterator(const std::vector<RangeMapBase<T> >& rlist) {
+    if(rlist.empty()) return;
+    Cursor c = { &rlist, static_cast<unsigned int>(rlist.size()) };
+    stack.push_back(c);
+    point.push_back(node(c).lower());
+    descend();
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  template<class T> inline
+  typename RangeMapPointIterator<T>::reference RangeMapPointIterator<T>::operator* () const {
+    return point;
+  }
+
+  template<class T> inline
+  typename RangeMapPointIterator<T>::pointer RangeMapPointIterator<T>::operator-> () const {
+    return &point;
+  }
+
+  template<class T> inline
+  RangeMapPointIterator<T>& RangeMapPointIterator<T>::operator++ () {
+    if(point.back() < run_upper()) ++point.back();
+    else                           next_run();
+    return *this;
+  }
+
+  template<class T> inline
+  RangeMapPointIterator<T> RangeMapPointIterator<T>::operator++ (int) {
+    RangeMapPointIterator rv(*this);
+    ++(*this);
+    return rv;
+  }
+
+  // a range of an upper level is visited once for every value it holds
+  template<class T> inline
+  RangeMapPointIterator<T>& RangeMapPointIterator<T>::next_run() {
+    while(!stack.empty()) {
+      Cursor& c = stack.back();
+      unsigned int l = stack.size() - 1;
+      if(!node(c).child.empty() && point[l] < node(c).upper()) {
+        ++point[l];                 // the next value of this range
+        break;
+      }
+      if(--c.left) {
+        point[l] = node(c).lower(); // the next range of this level
+        break;
+      }
+      stack.pop_back();
+    }
+    if(stack.empty()) point.clear();
+    else              descend();
+    return *this;
+  }
+
+  template<class T> inline
+  const T& RangeMapPointIterator<T>::run_lower() const {
+    return node(stack.back()).lower();
+  }
+
+  template<class T> inline
+  const T& RangeMapPointIterator<T>::run_upper() const {
+    return node(stack.back()).upper();
+  }
+
+  template<class T> inline
+  bool RangeMapPointIterator<T>::equal(const RangeMapPointIterator& r) const {
+    return stack.empty() == r.stack.empty() && point == r.point;
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  template<class T> inline
+  const RangeMapBase<T>& RangeMapPointIterator<T>::node(const Cursor& c) const {
+    return (*c.rlist)[c.left - 1];
+  }
+
+  // the point is set up to the top of the stack
+  template<class T> inline
+  void RangeMapPointIterator<T>::descend() {
+    while(!node(stack.back()).child.empty()) {
+      Cursor c = { &(node(stack.back()).child),
+                   static_cast<unsigned int>(node(stack.back()).child.size()) };
+      stack.push_back(c);
+      point.resize(stack.size());
+      point.back() = node(c).lower();
+    }
+  }
+
+  /////////////////////////////////////////////
+  // overload operators
+
+  template <class T>
+  inline bool operator== (const RangeMapPointIterator<T>& lhs, const RangeMapPointIterator<T>& rhs) {
+    return lhs.equal(rhs);
+  }
+
+  template <class T>
+  inline bool operator!= (const RangeMapPointIterator<T>& lhs, const RangeMapPointIterator<T>& rhs) {
+    return !lhs.equal(rhs);
+  }
+
+}
+
+#endif
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * Read-only breadth-first snapshot of a RangeMap
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_MAP_SNAPSHOT_H_
+#define _CPP_RANGE_MAP_SNAPSHOT_H_
+
+#include <list>
+#include <vector>
+#include <limits>
+#include <boost/cstdint.hpp>
+
+#include "cpp_range_map.hpp"
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeMapSnapshot
+  //
+  // a read-only copy of all nodes of a RangeMap in one array
+  // nodes are stored in breadth-first order so that the children of a node
+  // are contiguous and addressed by a 32-bit index into the array
+  // the array holds no pointer, so for a trivially copyable T (such as int)
+  // it can be copied by memcpy() and restored later, nodes of other T
+  // (such as cpp_int) must be copied one by one
+  // a map with 2^32 or more nodes cannot be addressed and is rejected
+  //
+  // not a storage mode of RangeMap, which keeps its own node vectors,
+  // convert a snapshot back to a RangeMap to operate on or modify it
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeMapSnapshot {
+  public:
+    typedef boost::uint32_t handle_type;
+
+    struct Node {
+      T upper;                  // the upper bound of the range
+      T lower;                  // the lower bound of the range
+      handle_type first;        // the index of the first child
+      handle_type size;         // the number of children, 0 for a leaf
+    };
+
+  private:
+    std::vector<Node> nodes;    // all nodes, top-level nodes first
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeMapSnapshot() {}
+    explicit RangeMapSnapshot(const RangeMap<T>&);      // take a snapshot of a RangeMap
+                                                        // throw InvalidRange with 2^32 or more nodes
+    RangeMapSnapshot(const Node*, handle_type);         // restore from a copied node array
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    // data accesser
+    const Node& operator[] (handle_type) const;         // access a node
+    const Node* data() const;                           // the raw node array
+    handle_type node_count() const;                     // the number of nodes
+    handle_type root_count() const;                     // the number of top-level nodes
+
+    unsigned int dimension() const;                     // the number of dimensions
+    T size() const;                                     // the size of the range
+    bool empty() const;                                 // ? this is an empty range
+    bool equal(const RangeMapSnapshot& r) const;        // ? this == r
+    RangeMap<T> toRangeMap() const;                     // convert back to a RangeMap
+    std::list<Range<T> > toRange() const;               // convert to Ranges
+    std::string toString(bool compress = true) const;   // simple conversion to string
+
+  private:
+    RangeElement<T> element(handle_type) const;         // the range of a node
+    T size(handle_type first, handle_type last) const;  // the size of a range of siblings
+    std::vector<RangeMapBase<T> >
+    toRangeMapBase(handle_type first, handle_type last) const;
+                                                        // rebuild a child list
+    std::string toString(handle_type first, handle_type last, bool compress) const;
+                                                        // convert a range of siblings
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+
+  // store a RangeMap in breadth-first order
+  template<class T> inline
+  RangeMapSnapshot<T>::RangeMapSnapshot(const RangeMap<T>& r) {
+    if(r.empty()) return;
+
+    // every index must fit in a handle
+    if(r.node_count() > static_cast<std::size_t>(std::numeric_limits<handle_type>::max())) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return;
+    }
+
+    std::vector<const RangeMapBase<T>*> queue;
+    BOOST_FOREACH(const RangeMapBase<T>& b, r.child)
+      queue.push_back(&b);
+
+    // the children of queue[i] are pushed to the queue when nodes[i] is built,
+    // so they always get the next free indices
+    nodes.resize(queue.size());
+    for(handle_type i=0; i<queue.size(); i++) {
+      const RangeMapBase<T>* b = queue[i];
+      nodes[i].upper = b->upper();
+      nodes[i].lower = b->lower();
+      nodes[i].first = queue.size();
+      nodes[i].size = b->child.size();
+      BOOST_FOREACH(const RangeMapBase<T>& c, b->child)
+        queue.push_back(&c);
+      nodes.resize(queue.size());
+    }
+  }
+
+  // restore from a copied node array
+  template<class T> inline
+  RangeMapSnapshot<T>::RangeMapSnapshot(const Node* array, handle_type n)
+    : nodes(array, array + n) {}
+
+  //////////////////////////////////////////////
+  // data accesser
+
+  template<class T> inline
+  const typename RangeMapSnapshot<T>::Node& RangeMapSnapshot<T>::operator[] (handle_type index) const {
+    return nodes.at(index);
+  }
+
+  template<class T> inline
+  const typename RangeMapSnapshot<T>::Node* RangeMapSnapshot<T>::data() const {
+    return nodes.empty() ? NULL : &nodes[0];
+  }
+
+  template<class T> inline
+  typename RangeMapSnapshot<T>::handle_type RangeMapSnapshot<T>::node_count() const {
+    return nodes.size();
+  }
+
+  // the children of the first top-level node follow the last top-level node
+  template<class T> inline
+  typename RangeMapSnapshot<T>::handle_type RangeMapSnapshot<T>::root_count() const {
+    if(nodes.empty()) return 0;
+    return nodes[0].size ? nodes[0].first : nodes.size();
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  // get the number of dimensions
+  template<class T> inline
+  unsigned int RangeMapSnapshot<T>::dimension() const {
+    if(nodes.empty()) return 0;
+    unsigned int rv = 1;
+    for(handle_type i = 0; nodes[i].size; i = nodes[i].first)
+      ++rv;
+    return rv;
+  }
+
+  // get the size of this range
+  template<class T> inline
+  T RangeMapSnapshot<T>::size() const {
+    return size(0, root_count());
+  }
+
+  // whether the range is empty
+  template<class T> inline
+  bool RangeMapSnapshot<T>::empty() const {
+    return nodes.empty();
+  }
+
+  // two snapshots of normalized RangeMaps are equal when their nodes are equal
+  template<class T> inline
+  bool RangeMapSnapshot<T>::equal(const RangeMapSnapshot& r) const {
+    if(nodes.size() != r.nodes.size()) return false;
+    for(handle_type i=0; i<nodes.size(); i++) {
+      if(nodes[i].upper != r.nodes[i].upper || nodes[i].lower != r.nodes[i].lower ||
+         nodes[i].first != r.nodes[i].first || nodes[i].size != r.nodes[i].size)
+        return false;
+    }
+    return true;
+  }
+
+  // convert back to a RangeMap
+  template<class T> inline
+  RangeMap<T> RangeMapSnapshot<T>::toRangeMap() const {
+    return RangeMap<T>(toRangeMapBase(0, root_count()));
+  }
+
+  // convert to a list of ranges
+  template<class T> inline
+  std::list<Range<T> > RangeMapSnapshot<T>::toRange() const {
+    return toRangeMap().toRange();
+  }
+
+  // convert to string
+  template<class T> inline
+  std::string RangeMapSnapshot<T>::toString(bool compress) const {
+    if(empty()) return "[]";
+    return toString(0, root_count(), compress);
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  template<class T> inline
+  RangeElement<T> RangeMapSnapshot<T>::element(handle_type index) const {
+    return RangeElement<T>(nodes[index].upper, nodes[index].lower);
+  }
+
+  template<class T> inline
+  T RangeMapSnapshot<T>::size(handle_type first, handle_type last) const {
+    T rv(0);
+    for(handle_type i=first; i<last; i++) {
+      if(nodes[i].size)
+        rv = size_add(rv, size_mul(element(i).size(),
+                                   size(nodes[i].first, nodes[i].first + nodes[i].size)));
+      else
+        rv = size_add(rv, element(i).size());
+    }
+    return rv;
+  }
+
+  template<class T> inline
+  std::vector<RangeMapBase<T> >
+  RangeMapSnapshot<T>::toRangeMapBase(handle_type first, handle_type last) const {
+    std::vector<RangeMapBase<T> > rv;
+    for(handle_type i=first; i<last; i++)
+      rv.push_back(RangeMapBase<T>(element(i),
+                                   toRangeMapBase(nodes[i].first, nodes[i].first + nodes[i].size)));
+    RangeMapBase<T>::accumulate(rv);
+    return rv;
+  }
+
+  // the same format as RangeMapBase::toString()
+  template<class T> inline
+  std::string RangeMapSnapshot<T>::toString(handle_type first, handle_type last, bool compress) const {
+    std::string rv;
+    if(last - first > 1) rv += "{";
+    for(handle_type i=first; i<last; i++) {
+      rv += element(i).toString(compress);
+      rv += toString(nodes[i].first, nodes[i].first + nodes[i].size, compress);
+      if(i + 1 != last) rv += ";";
+    }
+    if(last - first > 1) rv += "}";
+    return rv;
+  }
+
+  /////////////////////////////////////////////
+  // overload operators
+
+  // two ranges are equal
+  template <class T>
+  inline bool operator== (const RangeMapSnapshot<T>& lhs, const RangeMapSnapshot<T>& rhs) {
+    return lhs.equal(rhs);
+  }
+
+  // two ranges are not equal
+  template <class T>
+  inline bool operator!= (const RangeMapSnapshot<T>& lhs, const RangeMapSnapshot<T>& rhs) {
+    return !lhs.equal(rhs);
+  }
+
+  // standard out stream
+  template<class T>
+  std::ostream& operator<< (std::ostream& os, const RangeMapSnapshot<T>& r) {
+    os << r.toString();
+    return os;
+  }
+
+}
+
+#endif
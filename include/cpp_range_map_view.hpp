@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * RangeMap stored in a permuted dimension order
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_MAP_VIEW_H_
+#define _CPP_RANGE_MAP_VIEW_H_
+
+#include <vector>
+#include <algorithm>
+#include <boost/foreach.hpp>
+
+#include "cpp_range_map.hpp"
+#include "cpp_range_map_compressor.hpp"
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeMapView
+  //
+  // a RangeMap stored with its dimensions permuted, while points, maps
+  // and strings are still given in the original order
+  // the first dimension of a RangeMap splits the whole tree, so the same
+  // set may need far fewer nodes in another order, e.g. a dimension
+  // cut into many pieces is better placed last
+  // two views in the same order are operated directly on the stored maps
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeMapView {
+  private:
+    RangeMap<T> rmap;                   // the map in the stored order
+    std::vector<unsigned int> dim;      // the original dimension of each stored dimension
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeMapView();
+    explicit RangeMapView(const RangeMap<T>&);          // store a map in its best order
+    RangeMapView(const RangeMap<T>&, const std::vector<unsigned int>&);
+                                                        // store a map with dimension
+                                                        // order[i] moved to dimension i
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    const RangeMap<T>& stored() const;                  // the map in the stored order
+    const std::vector<unsigned int>& order() const;     // the original dimension of each
+                                                        // stored dimension
+    unsigned int dimension() const;                     // the number of dimensions
+    T size() const;                                     // the size of the range
+    bool empty() const;                                 // ? this is an empty range
+    std::size_t node_count() const;                     // the number of stored ranges
+    bool equal(const RangeMapView& r) const;            // ? this == r
+    bool contains(const std::vector<T>&) const;         // ? a point belongs to this range
+    bool contains(const T*) const;                      // ? a point (dimension() values)
+                                                        // belongs to this range
+    std::vector<bool> contains(const std::vector<std::vector<T> >&) const;
+                                                        // check a batch of points
+    RangeMapView combine(const RangeMapView& r) const;  // get the union of this and r
+    RangeMapView intersection(const RangeMapView& r) const;
+                                                        // get the intersection of this and r
+    RangeMapView complement(const RangeMapView& r) const;
+                                                        // subtract r from this range
+                                                        // ** results are stored in the
+                                                        // ** order of this view
+    RangeMapView optimize() const;                      // the same range in its best order
+    RangeMap<T> toRangeMap() const;                     // rebuild in the original order
+    std::string toString(bool compress = true) const;   // simple conversion to string
+
+    static std::vector<unsigned int> best_order(const RangeMap<T>&);
+                                                        // the order with the fewest nodes
+
+  private:
+    RangeMap<T> align(const RangeMapView&) const;       // the map of r in the stored order
+                                                        // of this view
+    std::vector<T> store(const T*) const;               // a point in the stored order
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+  template<class T> inline
+  RangeMapView<T>::RangeMapView() {}
+
+  template<class T> inline
+  RangeMapView<T>::RangeMapView(const RangeMap<T>& r)
+    : rmap(r), dim(r.dimension()) {
+    for(unsigned int i = 0; i < dim.size(); i++) dim[i] = i;
+    *this = optimize();
+  }
+
+  template<class T> inline
+  RangeMapView<T>::RangeMapView(const RangeMap<T>& r, const std::vector<unsigned int>& order)
+    : rmap(r.permute(order)) {
+    if(!rmap.empty()) dim = order;
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  template<class T> inline
+  const RangeMap<T>& RangeMapView<T>::stored() const {
+    return rmap;
+  }
+
+  template<class T> inline
+  const std::vector<unsigned int>& RangeMapView<T>::order() const {
+    return dim;
+  }
+
+  template<class T> inline
+  unsigned int RangeMapView<T>::dimension() const {
+    return rmap.dimension();
+  }
+
+  template<class T> inline
+  T RangeMapView<T>::size() const {
+    return rmap.size();
+  }
+
+  template<class T> inline
+  bool RangeMapView<T>::empty() const {
+    return rmap.empty();
+  }
+
+  template<class T> inline
+  std::size_t RangeMapView<T>::node_count() const {
+    return rmap.node_count();
+  }
+
+  template<class T> inline
+  bool RangeMapView<T>::equal(const RangeMapView& r) const {
+    return rmap.equal(align(r));
+  }
+
+  // a point of another dimension is passed on to report the error
+  template<class T> inline
+  bool RangeMapView<T>::contains(const std::vector<T>& point) const {
+    if(point.size() != dim.size() || dim.empty()) return rmap.contains(point);
+    return rmap.contains(store(&point[0]));
+  }
+
+  template<class T> inline
+  bool RangeMapView<T>::contains(const T* point) const {
+    if(dim.empty()) return false;
+    return rmap.contains(store(point));
+  }
+
+  template<class T> inline
+  std::vector<bool> RangeMapView<T>::contains(const std::vector<std::vector<T> >& points) const {
+    std::vector<std::vector<T> > plist(points);
+    for(std::size_t i = 0; i < plist.size(); i++)
+      if(plist[i].size() == dim.size() && !dim.empty())
+        plist[i] = store(&points[i][0]);
+    return rmap.contains(plist);
+  }
+
+  template<class T> inline
+  RangeMapView<T> RangeMapView<T>::combine(const RangeMapView& r) const {
+    if(empty()) return r;
+    RangeMapView rv(*this);
+    rv.rmap = rmap.combine(align(r));
+    return rv;
+  }
+
+  template<class T> inline
+  RangeMapView<T> RangeMapView<T>::intersection(const RangeMapView& r) const {
+    RangeMapView rv(*this);
+    rv.rmap = rmap.intersection(align(r));
+    if(rv.rmap.empty()) rv.dim.clear();
+    return rv;
+  }
+
+  template<class T> inline
+  RangeMapView<T> RangeMapView<T>::complement(const RangeMapView& r) const {
+    RangeMapView rv(*this);
+    rv.rmap = rmap.complement(align(r));
+    if(rv.rmap.empty()) rv.dim.clear();
+    return rv;
+  }
+
+  // the best order of the stored map is composed with the stored order
+  template<class T> inline
+  RangeMapView<T> RangeMapView<T>::optimize() const {
+    std::vector<unsigned int> best = best_order(rmap), order(dim.size());
+    bool same = true;
+    for(unsigned int i = 0; i < order.size(); i++) {
+      order[i] = dim[best[i]];
+      same = same && best[i] == i;
+    }
+    if(same) return *this;
+    RangeMapView rv(rmap, best);
+    rv.dim = order;
+    return rv;
+  }
+
+  // stored dimension i moves back to dimension dim[i]
+  template<class T> inline
+  RangeMap<T> RangeMapView<T>::toRangeMap() const {
+    std::vector<unsigned int> back(dim.size());
+    for(unsigned int i = 0; i < dim.size(); i++)
+      back[dim[i]] = i;
+    return rmap.permute(back);
+  }
+
+  template<class T> inline
+  std::string RangeMapView<T>::toString(bool compress) const {
+    return toRangeMap().toString(compress);
+  }
+
+  // a dimension with few breakpoints splits the tree into few branches,
+  // so dimensions are sorted by their number of breakpoints and the order
+  // is kept only when it has fewer nodes than the current one
+  // up to 3 dimensions (6 orders) all orders are counted
+  template<class T> inline
+  std::vector<unsigned int> RangeMapView<T>::best_order(const RangeMap<T>& r) {
+    std::vector<unsigned int> rv(r.dimension());
+    for(unsigned int i = 0; i < rv.size(); i++) rv[i] = i;
+    if(rv.size() < 2) return rv;
+
+    std::vector<std::vector<unsigned int> > candidate;
+    if(rv.size() <= 3) {
+      std::vector<unsigned int> order(rv);
+      while(std::next_permutation(order.begin(), order.end()))
+        candidate.push_back(order);
+    } else {
+      RangeMapCompressor<T> comp;
+      comp.add(r);
+      std::vector<std::pair<std::size_t, unsigned int> > cut;
+      for(unsigned int i = 0; i < rv.size(); i++)
+        cut.push_back(std::make_pair(comp.size(i), i));
+      std::stable_sort(cut.begin(), cut.end());
+      candidate.push_back(std::vector<unsigned int>());
+      for(unsigned int i = 0; i < cut.size(); i++)
+        candidate.back().push_back(cut[i].second);
+    }
+
+    std::size_t nodes = r.node_count();
+    BOOST_FOREACH(const std::vector<unsigned int>& order, candidate) {
+      std::size_t n = r.permute(order).node_count();
+      if(n < nodes) {
+        nodes = n;
+        rv = order;
+      }
+    }
+    return rv;
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  // r is permuted from its stored order to this stored order,
+  // a map of another dimension is passed on to report the error
+  template<class T> inline
+  RangeMap<T> RangeMapView<T>::align(const RangeMapView& r) const {
+    if(dim == r.dim || dim.size() != r.dim.size() || empty()) return r.rmap;
+    std::vector<unsigned int> where(dim.size()), order(dim.size());
+    for(unsigned int i = 0; i < dim.size(); i++)
+      where[r.dim[i]] = i;
+    for(unsigned int i = 0; i < dim.size(); i++)
+      order[i] = where[dim[i]];
+    return r.rmap.permute(order);
+  }
+
+  template<class T> inline
+  std::vector<T> RangeMapView<T>::store(const T* point) const {
+    std::vector<T> rv(dim.size());
+    for(unsigned int i = 0; i < dim.size(); i++)
+      rv[i] = point[dim[i]];
+    return rv;
+  }
+
+  /////////////////////////////////////////////
+  // overload operators
+
+  template <class T>
+  inline bool operator== (const RangeMapView<T>& lhs, const RangeMapView<T>& rhs) {
+    return lhs.equal(rhs);
+  }
+
+  template <class T>
+  inline bool operator!= (const RangeMapView<T>& lhs, const RangeMapView<T>& rhs) {
+    return !lhs.equal(rhs);
+  }
+
+  template <class T>
+  RangeMapView<T> operator& (const RangeMapView<T>& lhs, const RangeMapView<T>& rhs) {
+    return lhs.intersection(rhs);
+  }
+
+  template <class T>
+  RangeMapView<T> operator| (const RangeMapView<T>& lhs, const RangeMapView<T>& rhs) {
+    return lhs.combine(rhs);
+  }
+
+  // standard out stream
+  template<class T>
+  std::ostream& operator<< (std::ostream& os, const RangeMapView<T>& r) {
+    os << r.toString();
+    return os;
+  }
+
+}
+
+#endif
@@ -36,6 +36,7 @@
 #include <boost/foreach.hpp>
 
 #include "cpp_range_element.hpp"
+#include "cpp_range_small_vector.hpp"
 
 namespace CppRange {
 
@@ -48,8 +49,13 @@ namespace CppRange {
 
   template <class T>
   class Range {
+  public:
+    typedef RangeSmallVector<RangeElement<T>, CPP_RANGE_INLINE_DIMENSION> range_array;
+    typedef typename range_array::iterator iterator;
+    typedef typename range_array::const_iterator const_iterator;
+
   private:
-    std::vector<RangeElement<T> > r_array;              // the range array
+    range_array r_array;                                // the range array
 
   public:
     //////////////////////////////////////////////
@@ -78,14 +84,10 @@ namespace CppRange {
     const RangeElement<T>& operator[] (unsigned int) const;
     
     // get iterators
-    typename std::vector<RangeElement<T> >::iterator 
-    begin() { return r_array.begin(); }
-    typename std::vector<RangeElement<T> >::const_iterator 
-    begin() const { return r_array.begin(); }      
-    typename std::vector<RangeElement<T> >::iterator 
-    end() { return r_array.end(); }      
-    typename std::vector<RangeElement<T> >::const_iterator 
-    end() const { return r_array.end(); }      
+    iterator begin() { return r_array.begin(); }
+    const_iterator begin() const { return r_array.begin(); }      
+    iterator end() { return r_array.end(); }      
+    const_iterator end() const { return r_array.end(); }      
     
 
     unsigned int dimension() const;             // the number of dimensions
@@ -141,12 +143,12 @@ namespace CppRange {
   // construct from a list of RangeElements
   template<class T> inline
   Range<T>::Range(const std::list<RangeElement<T> >& l)
-    : r_array(std::vector<RangeElement<T> >(l.begin(), l.end())) {} 
+    : r_array(l.begin(), l.end()) {} 
 
   // construct from a vector of RangeElements
   template<class T> inline
   Range<T>::Range(const std::vector<RangeElement<T> >& l)
-    : r_array(l) {}
+    : r_array(l.begin(), l.end()) {}
 
   // construct from a list of raw range pairs
   template<class T> inline
@@ -202,7 +204,7 @@ namespace CppRange {
     
     T rv(1);
     for(unsigned int i=0; i<r_array.size(); i++)
-      rv = rv * r_array[i].size();
+      rv = size_mul(rv, r_array[i].size());
     return rv;
   }
   
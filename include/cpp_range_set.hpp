@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * Flat one dimensional range set
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_SET_H_
+#define _CPP_RANGE_SET_H_
+
+#include <list>
+#include <vector>
+#include <boost/foreach.hpp>
+
+#include "cpp_range_element.hpp"
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeSet
+  //
+  // a union of one dimensional ranges stored as a sorted array of
+  // range elements, from high to low, disjoint and not connected
+  // set operations are linear merges of the two arrays and the
+  // membership is a binary search
+  //
+  // the merges are also used by RangeMapBase on every list of leaf
+  // ranges, so a one dimensional RangeMap never recurses
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeSet {
+  private:
+    std::vector<RangeElement<T> > elem; // ranges from high to low
+
+  public:
+
+    // allow RangeMapBase and RangeMap to use the merges and the array
+    friend class RangeMapBase<T>;
+    friend class RangeMap<T>;
+
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeSet();
+    RangeSet(const T&);                                 // single bit range
+    RangeSet(const T&, const T&);                       // one range
+    explicit RangeSet(const RangeElement<T>&);          // convert a RangeElement
+    explicit RangeSet(const std::list<RangeElement<T> >&);
+                                                        // the union of a list of
+                                                        // RangeElement
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    T size() const;                                     // the number of values
+    bool empty() const;                                 // ? this is an empty set
+    const std::vector<RangeElement<T> >& ranges() const;// the ranges from high to low
+    bool contains(const T&) const;                      // ? a value belongs to this set
+    bool subset(const RangeSet&) const;                 // ? this is a subset of r
+    bool superset(const RangeSet&) const;               // ? this is a superset of r
+    bool equal(const RangeSet&) const;                  // ? this == r
+    bool overlap(const RangeSet&) const;                // this & r != []
+    bool disjoint(const RangeSet&) const;               // this & r == []
+    RangeSet combine(const RangeSet&) const;            // get the union of this and r
+    RangeSet intersection(const RangeSet&) const;       // get the intersection of this and r
+    RangeSet complement(const RangeSet&) const;         // subtract r from this set
+    RangeElement<T> hull() const;                       // the smallest range covering this set
+    void add(const RangeElement<T>&);                   // insert a range in place
+    void remove(const RangeElement<T>&);                // erase a range in place
+
+    std::string toString(bool compress = true) const;   // simple conversion to string
+
+  protected:
+    //////////////////////////////////
+    // static helper functions
+    // work on any sorted list of ranges constructible from (upper, lower)
+
+    template<class R>
+    static void combine(const std::vector<R>&, const std::vector<R>&, std::vector<R>&);
+                                                        // append the union of two lists
+    template<class R>
+    static void intersection(const std::vector<R>&, const std::vector<R>&, std::vector<R>&);
+                                                        // append the intersection of two lists
+    template<class R>
+    static void complement(const std::vector<R>&, const std::vector<R>&, std::vector<R>&);
+                                                        // append list l - list r
+    template<class R>
+    static bool subset(const std::vector<R>&, const std::vector<R>&);
+                                                        // ? list l is a subset of list r
+    template<class R>
+    static bool overlap(const std::vector<R>&, const std::vector<R>&);
+                                                        // ? two lists are overlapped
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+  template<class T> inline
+  RangeSet<T>::RangeSet() {}
+
+  template<class T> inline
+  RangeSet<T>::RangeSet(const T& r) {
+    add(RangeElement<T>(r));
+  }
+
+  template<class T> inline
+  RangeSet<T>::RangeSet(const T& rh, const T& rl) {
+    add(RangeElement<T>(rh, rl));
+  }
+
+  template<class T> inline
+  RangeSet<T>::RangeSet(const RangeElement<T>& r) {
+    add(r);
+  }
+
+  template<class T> inline
+  RangeSet<T>::RangeSet(const std::list<RangeElement<T> >& rlist) {
+    BOOST_FOREACH(const RangeElement<T>& r, rlist)
+      add(r);
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  template<class T> inline
+  T RangeSet<T>::size() const {
+    T rv(0);
+    BOOST_FOREACH(const RangeElement<T>& r, elem)
+      rv = size_add(rv, r.size());
+    return rv;
+  }
+
+  template<class T> inline
+  bool RangeSet<T>::empty() const {
+    return elem.empty();
+  }
+
+  template<class T> inline
+  const std::vector<RangeElement<T> >& RangeSet<T>::ranges() const {
+    return elem;
+  }
+
+  // the only candidate is the first range whose lower bound is not larger than v
+  template<class T> inline
+  bool RangeSet<T>::contains(const T& v) const {
+    std::size_t first = 0, last = elem.size();
+    while(first < last) {
+      std::size_t mid = (first + last) / 2;
+      if(v < elem[mid].lower()) first = mid + 1;
+      else                      last = mid;
+    }
+    return first != elem.size() && !(elem[first].upper() < v);
+  }
+
+  template<class T> inline
+  bool RangeSet<T>::subset(const RangeSet& r) const {
+    return subset(elem, r.elem);
+  }
+
+  template<class T> inline
+  bool RangeSet<T>::superset(const RangeSet& r) const {
+    return subset(r.elem, elem);
+  }
+
+  template<class T> inline
+  bool RangeSet<T>::equal(const RangeSet& r) const {
+    if(elem.size() != r.elem.size()) return false;
+    for(std::size_t i = 0; i < elem.size(); i++)
+      if(elem[i].upper() != r.elem[i].upper() || elem[i].lower() != r.elem[i].lower())
+        return false;
+    return true;
+  }
+
+  template<class T> inline
+  bool RangeSet<T>::overlap(const RangeSet& r) const {
+    return overlap(elem, r.elem);
+  }
+
+  template<class T> inline
+  bool RangeSet<T>::disjoint(const RangeSet& r) const {
+    return !overlap(elem, r.elem);
+  }
+
+  template<class T> inline
+  RangeSet<T> RangeSet<T>::combine(const RangeSet& r) const {
+    RangeSet rv;
+    combine(elem, r.elem, rv.elem);
+    return rv;
+  }
+
+  template<class T> inline
+  RangeSet<T> RangeSet<T>::intersection(const RangeSet& r) const {
+    RangeSet rv;
+    intersection(elem, r.elem, rv.elem);
+    return rv;
+  }
+
+  template<class T> inline
+  RangeSet<T> RangeSet<T>::complement(const RangeSet& r) const {
+    RangeSet rv;
+    complement(elem, r.elem, rv.elem);
+    return rv;
+  }
+
+  template<class T> inline
+  RangeElement<T> RangeSet<T>::hull() const {
+    if(elem.empty()) return RangeElement<T>();
+    return RangeElement<T>(elem.front().upper(), elem.back().lower());
+  }
+
+  // the ranges connected to r are replaced by their union with r
+  template<class T> inline
+  void RangeSet<T>::add(const RangeElement<T>& r) {
+    if(!r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return;
+    }
+    if(r.empty()) return;
+
+    // the first range not higher than r
+    std::size_t first = 0, last = elem.size();
+    while(first < last) {
+      std::size_t mid = (first + last) / 2;
+      if(separated(r.upper(), elem[mid].lower())) first = mid + 1;
+      else                                         last = mid;
+    }
+
+    // the ranges connected to r
+    T rh = r.upper(), rl = r.lower();
+    for(last = first; last < elem.size() && !separated(elem[last].upper(), r.lower()); ++last) {
+      if(rh < elem[last].upper()) rh = elem[last].upper();
+      if(elem[last].lower() < rl) rl = elem[last].lower();
+    }
+
+    if(first == last) {
+      elem.insert(elem.begin() + first, r);
+    } else {
+      elem[first] = RangeElement<T>(rh, rl);
+      elem.erase(elem.begin() + first + 1, elem.begin() + last);
+    }
+  }
+
+  // the ranges overlapped with r are replaced by what is left of them
+  template<class T> inline
+  void RangeSet<T>::remove(const RangeElement<T>& r) {
+    if(!r.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return;
+    }
+    if(r.empty()) return;
+
+    // the first range not higher than r
+    std::size_t first = 0, last = elem.size();
+    while(first < last) {
+      std::size_t mid = (first + last) / 2;
+      if(r.upper() < elem[mid].lower()) first = mid + 1;
+      else                              last = mid;
+    }
+
+    // the ranges overlapped with r
+    for(last = first; last < elem.size() && !(elem[last].upper() < r.lower()); ++last) {}
+    if(first == last) return;
+
+    std::vector<RangeElement<T> > rest;
+    if(r.upper() < elem[first].upper())
+      rest.push_back(RangeElement<T>(elem[first].upper(), r.upper() + min_unit<T>()));
+    if(elem[last-1].lower() < r.lower())
+      rest.push_back(RangeElement<T>(r.lower() - min_unit<T>(), elem[last-1].lower()));
+    elem.erase(elem.begin() + first, elem.begin() + last);
+    elem.insert(elem.begin() + first, rest.begin(), rest.end());
+  }
+
+  // convert to string, in the same format as a one dimensional RangeMap
+  template<class T> inline
+  std::string RangeSet<T>::toString(bool compress) const {
+    if(elem.empty()) return "[]";
+    if(elem.size() == 1) return elem.front().toString(compress);
+    std::string rv = "{";
+    for(std::size_t i = 0; i < elem.size(); i++) {
+      if(i) rv += ";";
+      rv += elem[i].toString(compress);
+    }
+    return rv + "}";
+  }
+
+  //////////////////////////////////
+  // static helper functions
+
+  // start from the higher of the two next ranges and absorb all ranges
+  // connected to it
+  template<class T> template<class R> inline
+  void RangeSet<T>::combine(const std::vector<R>& lhs, const std::vector<R>& rhs,
+                            std::vector<R>& rv) {
+    std::size_t i = 0, j = 0;
+    while(i < lhs.size() || j < rhs.size()) {
+      const R& r = (j == rhs.size() || (i < lhs.size() && !(lhs[i].upper() < rhs[j].upper())))
+        ? lhs[i++] : rhs[j++];
+      T rh = r.upper(), rl = r.lower();
+      for(;;) {
+        if(i < lhs.size() && !separated(lhs[i].upper(), rl)) {
+          if(lhs[i].lower() < rl) rl = lhs[i].lower();
+          ++i;
+        } else if(j < rhs.size() && !separated(rhs[j].upper(), rl)) {
+          if(rhs[j].lower() < rl) rl = rhs[j].lower();
+          ++j;
+        } else
+          break;
+      }
+      rv.push_back(R(rh, rl));
+    }
+  }
+
+  // the range ending first (with the higher lower bound) proceeds
+  template<class T> template<class R> inline
+  void RangeSet<T>::intersection(const std::vector<R>& lhs, const std::vector<R>& rhs,
+                                 std::vector<R>& rv) {
+    std::size_t i = 0, j = 0;
+    while(i < lhs.size() && j < rhs.size()) {
+      T rh = lhs[i].upper() < rhs[j].upper() ? lhs[i].upper() : rhs[j].upper();
+      T rl = lhs[i].lower() < rhs[j].lower() ? rhs[j].lower() : lhs[i].lower();
+      if(!(rh < rl)) rv.push_back(R(rh, rl));
+      if(rhs[j].lower() < lhs[i].lower()) ++i;
+      else                                ++j;
+    }
+  }
+
+  // the ranges of rhs cut each range of lhs from its upper bound downwards,
+  // a range of rhs reaching below the current range of lhs is kept for the next one
+  template<class T> template<class R> inline
+  void RangeSet<T>::complement(const std::vector<R>& lhs, const std::vector<R>& rhs,
+                               std::vector<R>& rv) {
+    std::size_t j = 0;
+    BOOST_FOREACH(const R& r, lhs) {
+      while(j < rhs.size() && r.upper() < rhs[j].lower()) ++j;
+      T rh = r.upper();
+      bool left = true;
+      for(; j < rhs.size() && !(rhs[j].upper() < r.lower()); ++j) {
+        if(rhs[j].upper() < rh) rv.push_back(R(rh, rhs[j].upper() + min_unit<T>()));
+        if(!(r.lower() < rhs[j].lower())) {
+          left = false;
+          break;
+        }
+        rh = rhs[j].lower() - min_unit<T>();
+      }
+      if(left) rv.push_back(R(rh, r.lower()));
+    }
+  }
+
+  // every range of lhs must be inside a single range of rhs
+  template<class T> template<class R> inline
+  bool RangeSet<T>::subset(const std::vector<R>& lhs, const std::vector<R>& rhs) {
+    std::size_t j = 0;
+    BOOST_FOREACH(const R& r, lhs) {
+      while(j < rhs.size() && r.upper() < rhs[j].lower()) ++j;
+      if(j == rhs.size() || rhs[j].upper() < r.upper() || r.lower() < rhs[j].lower())
+        return false;
+    }
+    return true;
+  }
+
+  template<class T> template<class R> inline
+  bool RangeSet<T>::overlap(const std::vector<R>& lhs, const std::vector<R>& rhs) {
+    std::size_t i = 0, j = 0;
+    while(i < lhs.size() && j < rhs.size()) {
+      if(lhs[i].upper() < rhs[j].lower())      ++j;
+      else if(rhs[j].upper() < lhs[i].lower()) ++i;
+      else                                     return true;
+    }
+    return false;
+  }
+
+  /////////////////////////////////////////////
+  // overload operators
+
+  template <class T>
+  inline bool operator== (const RangeSet<T>& lhs, const RangeSet<T>& rhs) {
+    return lhs.equal(rhs);
+  }
+
+  template <class T>
+  inline bool operator!= (const RangeSet<T>& lhs, const RangeSet<T>& rhs) {
+    return !lhs.equal(rhs);
+  }
+
+  template <class T>
+  RangeSet<T> operator& (const RangeSet<T>& lhs, const RangeSet<T>& rhs) {
+    return lhs.intersection(rhs);
+  }
+
+  template <class T>
+  RangeSet<T> operator| (const RangeSet<T>& lhs, const RangeSet<T>& rhs) {
+    return lhs.combine(rhs);
+  }
+
+  template<class T>
+  std::ostream& operator<< (std::ostream& os, const RangeSet<T>& r) {
+    os << r.toString();
+    return os;
+  }
+
+}
+
+#endif
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * A vector with a small inline buffer
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_SMALL_VECTOR_H_
+#define _CPP_RANGE_SMALL_VECTOR_H_
+
+#include <cstddef>
+#include <stdexcept>
+
+// the number of dimensions stored inside a Range object
+// ranges with more dimensions are stored in the heap
+#ifndef CPP_RANGE_INLINE_DIMENSION
+#define CPP_RANGE_INLINE_DIMENSION 4
+#endif
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeSmallVector
+  //
+  // a vector keeping up to N elements inside the object
+  // only the operations used by Range and the map iterators are provided
+  // elements are copied one by one, so it works in C++03 and the copy of
+  // an inline buffer never reads more than N elements
+  // E should be default constructible and cheap to copy
+  //
+  //////////////////////////////////////////////////
+  template <class E, std::size_t N>
+  class RangeSmallVector {
+  public:
+    typedef E value_type;
+    typedef E* iterator;
+    typedef const E* const_iterator;
+    typedef std::size_t size_type;
+
+  private:
+    E buf[N];                   // the inline buffer
+    E* data;                    // buf or a heap array
+    size_type n;                // the number of elements
+    size_type cap;              // the capacity of data
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeSmallVector();
+    RangeSmallVector(const RangeSmallVector&);
+    template <class I>
+    RangeSmallVector(I, I);                             // copy a sequence
+#if __cplusplus >= 201103L
+    RangeSmallVector(RangeSmallVector&&);               // steal a heap array
+#endif
+    ~RangeSmallVector();
+
+    RangeSmallVector& operator= (const RangeSmallVector&);
+#if __cplusplus >= 201103L
+    RangeSmallVector& operator= (RangeSmallVector&&);
+#endif
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    iterator begin() { return data; }
+    const_iterator begin() const { return data; }
+    iterator end() { return data + n; }
+    const_iterator end() const { return data + n; }
+    size_type size() const { return n; }
+    bool empty() const { return n == 0; }
+    E& operator[] (size_type i) { return data[i]; }
+    const E& operator[] (size_type i) const { return data[i]; }
+    E& at(size_type);                                   // throw std::out_of_range
+    const E& at(size_type) const;
+    E& back() { return data[n-1]; }
+    const E& back() const { return data[n-1]; }
+
+    void reserve(size_type);
+    void resize(size_type);                             // new elements are E()
+    void push_back(const E&);
+    void pop_back() { --n; }
+    iterator insert(iterator, const E&);
+    iterator erase(iterator);
+    void clear() { n = 0; }
+
+  private:
+    void steal(RangeSmallVector&);                      // take the elements of r
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+  template<class E, std::size_t N> inline
+  RangeSmallVector<E,N>::RangeSmallVector()
+    : data(buf), n(0), cap(N) {}
+
+  template<class E, std::size_t N> inline
+  RangeSmallVector<E,N>::RangeSmallVector(const RangeSmallVector& r)
+    : data(buf), n(0), cap(N) {
+    *this = r;
+  }
+
+  template<class E, std::size_t N> template<class I> inline
+  RangeSmallVector<E,N>::RangeSmallVector(I first, I last)
+    : data(buf), n(0), cap(N) {
+    for(; first != last; ++first) push_back(*first);
+  }
+
+#if __cplusplus >= 201103L
+  template<class E, std::size_t N> inline
+  RangeSmallVector<E,N>::RangeSmallVector(RangeSmallVector&& r)
+    : data(buf), n(0), cap(N) {
+    steal(r);
+  }
+#endif
+
+  template<class E, std::size_t N> inline
+  RangeSmallVector<E,N>::~RangeSmallVector() {
+    if(data != buf) delete[] data;
+  }
+
+  template<class E, std::size_t N> inline
+  RangeSmallVector<E,N>& RangeSmallVector<E,N>::operator= (const RangeSmallVector& r) {
+    if(this == &r) return *this;
+    n = 0;
+    reserve(r.n);
+    for(size_type i = 0; i < r.n; i++) data[i] = r.data[i];
+    n = r.n;
+    return *this;
+  }
+
+#if __cplusplus >= 201103L
+  template<class E, std::size_t N> inline
+  RangeSmallVector<E,N>& RangeSmallVector<E,N>::operator= (RangeSmallVector&& r) {
+    if(this != &r) steal(r);
+    return *this;
+  }
+#endif
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  template<class E, std::size_t N> inline
+  E& RangeSmallVector<E,N>::at(size_type i) {
+    if(i >= n) throw std::out_of_range("RangeSmallVector::at");
+    return data[i];
+  }
+
+  template<class E, std::size_t N> inline
+  const E& RangeSmallVector<E,N>::at(size_type i) const {
+    if(i >= n) throw std::out_of_range("RangeSmallVector::at");
+    return data[i];
+  }
+
+  // the capacity is at least doubled to keep push_back amortized O(1)
+  template<class E, std::size_t N> inline
+  void RangeSmallVector<E,N>::reserve(size_type c) {
+    if(c <= cap) return;
+    if(c < 2*cap) c = 2*cap;
+    E* d = new E[c];
+    for(size_type i = 0; i < n; i++) d[i] = data[i];
+    if(data != buf) delete[] data;
+    data = d;
+    cap = c;
+  }
+
+  template<class E, std::size_t N> inline
+  void RangeSmallVector<E,N>::resize(size_type s) {
+    reserve(s);
+    for(size_type i = n; i < s; i++) data[i] = E();
+    n = s;
+  }
+
+  // v may be an element of this vector
+  template<class E, std::size_t N> inline
+  void RangeSmallVector<E,N>::push_back(const E& v) {
+    if(n == cap) {
+      E tmp(v);
+      reserve(n+1);
+      data[n++] = tmp;
+    } else
+      data[n++] = v;
+  }
+
+  template<class E, std::size_t N> inline
+  typename RangeSmallVector<E,N>::iterator
+  RangeSmallVector<E,N>::insert(iterator pos, const E& v) {
+    size_type p = pos - data;
+    E tmp(v);
+    reserve(n+1);
+    for(size_type i = n; i > p; i--) data[i] = data[i-1];
+    data[p] = tmp;
+    n++;
+    return data + p;
+  }
+
+  template<class E, std::size_t N> inline
+  typename RangeSmallVector<E,N>::iterator
+  RangeSmallVector<E,N>::erase(iterator pos) {
+    for(iterator it = pos; it + 1 < end(); ++it) *it = *(it + 1);
+    n--;
+    return pos;
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  // a heap array is moved, an inline buffer is copied
+  template<class E, std::size_t N> inline
+  void RangeSmallVector<E,N>::steal(RangeSmallVector& r) {
+    if(r.data == r.buf) {
+      *this = static_cast<const RangeSmallVector&>(r);
+      return;
+    }
+    if(data != buf) delete[] data;
+    data = r.data;
+    n = r.n;
+    cap = r.cap;
+    r.data = r.buf;
+    r.n = 0;
+    r.cap = N;
+  }
+
+}
+
+#endif
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * Strided one dimensional range
+ * 18/10/2026
+ *
+ *
+ */
+
+#ifndef _CPP_RANGE_STRIDE_H_
+#define _CPP_RANGE_STRIDE_H_
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "cpp_range_element.hpp"
+#include "cpp_range_set.hpp"
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeStride
+  //
+  // every step-th value of a range, [upper:lower:step], such as the
+  // bits of a generate loop or a bank of an interleaved memory
+  // the upper bound is always a member (lower + k * step)
+  // the step is unsigned as two members may be further apart than
+  // the largest value of a signed type
+  //
+  // the size, membership, containment and intersection are closed form,
+  // two strides meet on the solution of a pair of congruences (CRT),
+  // which is again a stride of the least common multiple of both steps
+  // only integral domains are supported
+  //
+  //////////////////////////////////////////////////
+  template <class T>
+  class RangeStride {
+  public:
+    typedef typename boost::make_unsigned<T>::type step_type;
+
+  private:
+    RangeElement<T> r;          // the highest and the lowest member
+    step_type s;                // the distance between two neighbouring members
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeStride();
+    RangeStride(const T&, const T&, step_type step = 1);
+                                                        // [upper:lower:step], the upper
+                                                        // bound is rounded down to a member
+    explicit RangeStride(const RangeElement<T>&);       // a range of step 1
+    explicit RangeStride(const std::string&);           // parse "[15:0:4]", "[7:0]" or "[3]"
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    // data accessers
+    const T& upper() const;                             // the highest member
+    const T& lower() const;                             // the lowest member
+    const step_type& step() const;                      // the distance of two members
+
+    T size() const;                                     // the number of members
+    bool valid() const;                                 // ? a positive step and legal bounds
+    bool empty() const;                                 // ? this is empty
+    bool in(const T&) const;                            // ? a value is a member
+    bool subset(const RangeStride&) const;              // ? this is a subset of r
+    bool equal(const RangeStride&) const;               // ? this == r
+    bool overlap(const RangeStride&) const;             // this & r != []
+    RangeStride intersection(const RangeStride&) const; // get the intersection of this and r
+    RangeElement<T> hull() const;                       // the range from lower to upper
+    RangeSet<T> toSet() const;                          // expand the members
+
+    std::string toString(bool compress = true) const;   // simple conversion to string
+
+  private:
+    typedef boost::uintmax_t uint_type;
+
+    static uint_type distance(const T&, const T&);      // upper - lower without overflow
+    static T advance(const T&, uint_type);              // a value plus a distance
+    static uint_type gcd(uint_type, uint_type);
+    static uint_type mulmod(uint_type, uint_type, uint_type);
+                                                        // a * b mod m without overflow
+    static uint_type inverse(uint_type, uint_type);     // the modular inverse of a coprime
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+  template<class T> inline
+  RangeStride<T>::RangeStride()
+    : s(1) {}
+
+  template<class T> inline
+  RangeStride<T>::RangeStride(const T& rh, const T& rl, step_type step)
+    : r(rh, rl), s(step) {
+    if(valid() && !empty() && s > 1)
+      r.upper(advance(rl, distance(rh, rl) / s * s));
+  }
+
+  template<class T> inline
+  RangeStride<T>::RangeStride(const RangeElement<T>& re)
+    : r(re), s(1) {}
+
+  // the step is the third field, a range without it has step 1
+  // the step is read as step_type, a negative or zero step is invalid
+  template<class T> inline
+  RangeStride<T>::RangeStride(const std::string& str)
+    : s(1) {
+    std::vector<std::string> fields;
+    boost::split(fields, str, boost::is_any_of("[:]"), boost::token_compress_on);
+    if(fields.size() == 5) {
+      step_type step = fields[3].find('-') == std::string::npos ?
+        boost::lexical_cast<step_type>(fields[3]) : step_type(0);
+      *this = RangeStride(boost::lexical_cast<T>(fields[1]),
+                          boost::lexical_cast<T>(fields[2]),
+                          step);
+#ifndef CPP_RANGE_NO_EXCEPTION
+      if(s == 0) throw(RangeException_InvalidRange());
+#endif
+    } else
+      r = parse_range<T>(str);
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  template<class T> inline
+  const T& RangeStride<T>::upper() const {
+    return r.upper();
+  }
+
+  template<class T> inline
+  const T& RangeStride<T>::lower() const {
+    return r.lower();
+  }
+
+  template<class T> inline
+  const typename RangeStride<T>::step_type& RangeStride<T>::step() const {
+    return s;
+  }
+
+  // saturated at the largest value of T as the size of a range
+  template<class T> inline
+  T RangeStride<T>::size() const {
+    if(empty()) return T(0);
+    uint_type n = distance(upper(), lower()) / s;
+    if(n >= uint_type(std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+    return T(n + 1);
+  }
+
+  template<class T> inline
+  bool RangeStride<T>::valid() const {
+    return r.valid() && s > 0;
+  }
+
+  // not by the size of the hull, which may not fit in T
+  template<class T> inline
+  bool RangeStride<T>::empty() const {
+    return upper() < lower();
+  }
+
+  template<class T> inline
+  bool RangeStride<T>::in(const T& v) const {
+    return !(v < lower()) && !(upper() < v) &&
+      distance(v, lower()) % s == 0;
+  }
+
+  // a stride of more than one member is inside r when its first member is
+  // a member of r, its last member is not above r and its step is a
+  // multiple of the step of r
+  template<class T> inline
+  bool RangeStride<T>::subset(const RangeStride& rs) const {
+    if(!valid() || !rs.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return false;
+    }
+    if(empty()) return true;
+    if(!rs.in(lower()) || rs.upper() < upper()) return false;
+    return upper() == lower() || s % rs.s == 0;
+  }
+
+  template<class T> inline
+  bool RangeStride<T>::equal(const RangeStride& rs) const {
+    if(empty() || rs.empty()) return empty() && rs.empty();
+    return r.equal(rs.r) && (upper() == lower() || s == rs.s);
+  }
+
+  template<class T> inline
+  bool RangeStride<T>::overlap(const RangeStride& rs) const {
+    return !intersection(rs).empty();
+  }
+
+  // both strides are shifted to the higher lower bound 'lo', where their
+  // first members are at the offsets a and b, the shared members are then
+  // the offsets t = a (mod s1) = b (mod s2), which exist only when
+  // a = b (mod gcd) and repeat every lcm(s1, s2)
+  template<class T> inline
+  RangeStride<T> RangeStride<T>::intersection(const RangeStride& rs) const {
+    if(!valid() || !rs.valid()) {
+#ifndef CPP_RANGE_NO_EXCEPTION
+      throw(RangeException_InvalidRange());
+#endif
+      return RangeStride();
+    }
+    if(empty() || rs.empty()) return RangeStride();
+    T hi = std::min(upper(), rs.upper());
+    T lo = std::max(lower(), rs.lower());
+    if(hi < lo) return RangeStride();
+
+    uint_type span = distance(hi, lo);
+    uint_type s1 = s, s2 = rs.s;
+    uint_type a = (s1 - distance(lo, lower()) % s1) % s1;
+    uint_type b = (s2 - distance(lo, rs.lower()) % s2) % s2;
+    uint_type g = gcd(s1, s2);
+    if(a % g != b % g) return RangeStride();
+
+    // s1 * k = b - a (mod s2), solved on the reduced moduli
+    uint_type m = s2 / g;
+    uint_type d = b >= a % s2 ? b - a % s2 : b + (s2 - a % s2);   // b - a (mod s2)
+    uint_type k = mulmod(d / g, inverse(s1 / g % m, m), m);
+    if(k != 0 && (span < a || (span - a) / k < s1)) return RangeStride();
+    uint_type t = a + s1 * k;
+    if(span < t) return RangeStride();
+
+    // a common step beyond the span leaves a single member
+    T first = advance(lo, t);
+    if(m > (span - t) / s1) return RangeStride(first, first);
+    uint_type l = s1 * m;
+    return RangeStride(advance(first, (span - t) / l * l), first, step_type(l));
+  }
+
+  template<class T> inline
+  RangeElement<T> RangeStride<T>::hull() const {
+    return r;
+  }
+
+  template<class T> inline
+  RangeSet<T> RangeStride<T>::toSet() const {
+    if(empty() || s == 1) return RangeSet<T>(r);
+    RangeSet<T> rv;
+    for(T v = upper(); ; v = advance(v, -s)) {
+      rv.add(RangeElement<T>(v));
+      if(v == lower()) break;
+    }
+    return rv;
+  }
+
+  template<class T> inline
+  std::string RangeStride<T>::toString(bool compress) const {
+    if(empty() || s == 1 || upper() == lower()) return r.toString(compress);
+    return
+      "[" + boost::lexical_cast<std::string>(upper()) +
+      ":" + boost::lexical_cast<std::string>(lower()) +
+      ":" + boost::lexical_cast<std::string>(s) + "]";
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  // computed in unsigned arithmetic so a wide range never overflows
+  template<class T> inline
+  typename RangeStride<T>::uint_type RangeStride<T>::distance(const T& rh, const T& rl) {
+    return static_cast<uint_type>(rh) - static_cast<uint_type>(rl);
+  }
+
+  template<class T> inline
+  T RangeStride<T>::advance(const T& v, uint_type d) {
+    return T(static_cast<uint_type>(v) + d);
+  }
+
+  template<class T> inline
+  typename RangeStride<T>::uint_type RangeStride<T>::gcd(uint_type a, uint_type b) {
+    while(b) {
+      uint_type t = a % b;
+      a = b;
+      b = t;
+    }
+    return a;
+  }
+
+  // double and add, each partial sum stays below m
+  template<class T> inline
+  typename RangeStride<T>::uint_type
+  RangeStride<T>::mulmod(uint_type a, uint_type b, uint_type m) {
+    uint_type rv = 0;
+    a %= m;
+    for(; b; b >>= 1) {
+      if(b & 1) rv = rv < m - a ? rv + a : rv - (m - a);
+      a = a < m - a ? a + a : a - (m - a);
+    }
+    return rv;
+  }
+
+  // the extended Euclidean algorithm with the coefficients kept modulo m
+  template<class T> inline
+  typename RangeStride<T>::uint_type RangeStride<T>::inverse(uint_type a, uint_type m) {
+    if(m == 1) return 0;
+    uint_type r0 = m, r1 = a, t0 = 0, t1 = 1;
+    while(r1) {
+      uint_type q = r0 / r1, rt = r0 - q * r1, x = mulmod(q, t1, m);
+      uint_type tt = t0 >= x ? t0 - x : t0 + (m - x);       // t0 - x (mod m), m may be above 2^63
+      r0 = r1; r1 = rt;
+      t0 = t1; t1 = tt;
+    }
+    return t0;
+  }
+
+  /////////////////////////////////////////////
+  // overload operators
+
+  template <class T>
+  inline bool operator== (const RangeStride<T>& lhs, const RangeStride<T>& rhs) {
+    return lhs.equal(rhs);
+  }
+
+  template <class T>
+  inline bool operator!= (const RangeStride<T>& lhs, const RangeStride<T>& rhs) {
+    return !lhs.equal(rhs);
+  }
+
+  template <class T>
+  RangeStride<T> operator& (const RangeStride<T>& lhs, const RangeStride<T>& rhs) {
+    return lhs.intersection(rhs);
+  }
+
+  template<class T>
+  std::ostream& operator<< (std::ostream& os, const RangeStride<T>& r) {
+    os << r.toString();
+    return os;
+  }
+
+}
+
+#endif
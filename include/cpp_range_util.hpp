@@ -30,6 +30,7 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/xpressive/xpressive.hpp>
+#include <boost/foreach.hpp>
 #include <list>
 #include <string>
 
@@ -51,7 +52,7 @@ namespace CppRange {
   // parse a simple range
   template<class T>
   RangeElement<T> parse_range(const std::string& str_arg) {
-    // parse something like "[3:0]", "[4]" or even "[]"
+    // parse something like "[3:0]", "[4]", "[*]" or even "[]"
 
     std::string str(str_arg);
     if(str.length() < 2) return RangeElement<T>(); // throw e
@@ -68,6 +69,8 @@ namespace CppRange {
       return RangeElement<T>();
     }
     case 3: {
+      if(fields[1] == "*")     // a wildcard
+        return RangeElement<T>(full_upper<T>(), full_lower<T>());
       return RangeElement<T>(boost::lexical_cast<T>(fields[1]));
     }
     case 4: {
@@ -105,6 +108,15 @@ namespace CppRange {
     
     return rv;
   }
+
+  // print a point like [3][0][-2]
+  template<class T>
+  std::string point_string(const std::vector<T>& point) {
+    std::string rv;
+    BOOST_FOREACH(const T& v, point)
+      rv += "[" + boost::lexical_cast<std::string>(v) + "]";
+    return rv;
+  }
   
 }
 
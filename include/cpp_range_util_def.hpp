@@ -28,6 +28,7 @@
 #define _CPP_RANGE_UTIL_DEF_H_
 
 #include <list>
+#include <vector>
 #include <string>
 
 namespace CppRange {
@@ -37,6 +38,15 @@ namespace CppRange {
   template<class T> class Range;
   template<class T> class RangeMapBase;
   template<class T> class RangeMap;
+  template<class T> class RangeMapSnapshot;
+  template<class T> class RangeBTree;
+  template<class T> class RangeMapIterator;
+  template<class T> class RangeMapPointIterator;
+  template<class T> class RangeMapCache;
+  template<class T> class RangeMapCompressor;
+  template<class T> class RangeMapView;
+  template<class T> class RangeSet;
+  template<class T> class RangeStride;
   
   // parse a string into a range element
   template<class T>
@@ -46,6 +56,10 @@ namespace CppRange {
   template<class T>
   std::list<RangeElement<T> > parse_range_list (const std::string&);
 
+  // print a point as a list of single bit ranges
+  template<class T>
+  std::string point_string (const std::vector<T>&);
+
 
 }
 
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2014-2014 Wei Song <songw@cs.man.ac.uk>
+ *    Advanced Processor Technologies Group, School of Computer Science
+ *    University of Manchester, Manchester M13 9PL UK
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ *
+ */
+
+/*
+ * An C++ STL static range calculation library
+ * Wide integer bound with an inline 64-bit fast path
+ * 18/10/2026
+ *
+ * Note: not included by cpp_range.hpp, Boost.Multiprecision needs C++11
+ *
+ */
+
+#ifndef _CPP_RANGE_WIDE_H_
+#define _CPP_RANGE_WIDE_H_
+
+#include <limits>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace CppRange {
+  class RangeWideInt;
+}
+
+namespace std {
+
+  // an unbounded exact integer, as cpp_int
+  // specialized before any use of the class
+  template<>
+  class numeric_limits<CppRange::RangeWideInt>
+    : public numeric_limits<boost::multiprecision::cpp_int> {
+  public:
+    static CppRange::RangeWideInt min();
+    static CppRange::RangeWideInt max();
+    static CppRange::RangeWideInt lowest();
+  };
+
+}
+
+namespace CppRange {
+
+  //////////////////////////////////////////////////
+  // RangeWideInt
+  //
+  // an unbounded signed integer for range bounds wider than 64 bits
+  // a value fitting in 64 bits is stored inline and operated natively,
+  // only a value out of it is moved to a boost cpp_int on the heap,
+  // results are moved back inline whenever they fit again,
+  // so every value has a single representation
+  //
+  //////////////////////////////////////////////////
+  class RangeWideInt {
+  public:
+    typedef boost::multiprecision::cpp_int wide_type;
+
+  private:
+    boost::int64_t v;           // the value when it fits in 64 bits
+    wide_type* w;               // the value otherwise, NULL for an inline value
+
+  public:
+    //////////////////////////////////////////////
+    // constructors
+
+    RangeWideInt();
+    RangeWideInt(int);
+    RangeWideInt(unsigned int);
+    RangeWideInt(long);
+    RangeWideInt(unsigned long);
+    RangeWideInt(long long);
+    RangeWideInt(unsigned long long);
+    RangeWideInt(const wide_type&);
+    RangeWideInt(const RangeWideInt&);
+    ~RangeWideInt();
+    RangeWideInt& operator= (const RangeWideInt&);
+
+    //////////////////////////////////////////////
+    // Helpers
+
+    bool inline_value() const;                          // ? the value fits in 64 bits
+    wide_type wide() const;                             // the value as a cpp_int
+    std::string str() const;                            // decimal string
+    template<class I>
+    explicit operator I() const;                        // the low bits of the two's
+                                                        // complement, as a cast does
+    static int compare(const RangeWideInt&, const RangeWideInt&);
+                                                        // -1, 0 or 1
+
+    RangeWideInt& operator+= (const RangeWideInt&);
+    RangeWideInt& operator-= (const RangeWideInt&);
+    RangeWideInt& operator*= (const RangeWideInt&);
+    RangeWideInt& operator/= (const RangeWideInt&);
+    RangeWideInt& operator%= (const RangeWideInt&);
+    RangeWideInt operator- () const;
+
+  private:
+    void assign(const wide_type&);                      // store inline when it fits
+  };
+
+  /////////////////////////////////////////////
+  // implementation of class methods
+
+  // constructors
+  inline RangeWideInt::RangeWideInt() : v(0), w(NULL) {}
+  inline RangeWideInt::RangeWideInt(int n) : v(n), w(NULL) {}
+  inline RangeWideInt::RangeWideInt(unsigned int n) : v(n), w(NULL) {}
+  inline RangeWideInt::RangeWideInt(long n) : v(n), w(NULL) {}
+  inline RangeWideInt::RangeWideInt(long long n) : v(n), w(NULL) {}
+
+  inline RangeWideInt::RangeWideInt(unsigned long n) : v(0), w(NULL) {
+    if(n > static_cast<unsigned long>(std::numeric_limits<boost::int64_t>::max()))
+      w = new wide_type(n);
+    else
+      v = static_cast<boost::int64_t>(n);
+  }
+
+  inline RangeWideInt::RangeWideInt(unsigned long long n) : v(0), w(NULL) {
+    if(n > static_cast<unsigned long long>(std::numeric_limits<boost::int64_t>::max()))
+      w = new wide_type(n);
+    else
+      v = static_cast<boost::int64_t>(n);
+  }
+
+  inline RangeWideInt::RangeWideInt(const wide_type& n) : v(0), w(NULL) {
+    assign(n);
+  }
+
+  inline RangeWideInt::RangeWideInt(const RangeWideInt& r)
+    : v(r.v), w(r.w ? new wide_type(*r.w) : NULL) {}
+
+  inline RangeWideInt::~RangeWideInt() {
+    delete w;
+  }
+
+  inline RangeWideInt& RangeWideInt::operator= (const RangeWideInt& r) {
+    if(this == &r) return *this;
+    if(r.w) {
+      if(w) *w = *r.w;
+      else  w = new wide_type(*r.w);
+    } else {
+      delete w;
+      w = NULL;
+      v = r.v;
+    }
+    return *this;
+  }
+
+  //////////////////////////////////////////////
+  // Helpers
+
+  inline bool RangeWideInt::inline_value() const {
+    return w == NULL;
+  }
+
+  inline RangeWideInt::wide_type RangeWideInt::wide() const {
+    return w ? *w : wide_type(v);
+  }
+
+  inline std::string RangeWideInt::str() const {
+    return w ? w->str() : wide_type(v).str();
+  }
+
+  // the distance of two wide values survives an unsigned cast
+  template<class I> inline
+  RangeWideInt::operator I() const {
+    if(!w) return static_cast<I>(v);
+    wide_type m = *w % (wide_type(1) << 64);
+    if(m < 0) m += wide_type(1) << 64;
+    return static_cast<I>(m.convert_to<boost::uint64_t>());
+  }
+
+  inline int RangeWideInt::compare(const RangeWideInt& lhs, const RangeWideInt& rhs) {
+    if(!lhs.w && !rhs.w) return lhs.v < rhs.v ? -1 : (rhs.v < lhs.v ? 1 : 0);
+    if(!rhs.w) return *lhs.w < rhs.v ? -1 : 1;  // a wide value is out of the 64 bits
+    if(!lhs.w) return lhs.v < *rhs.w ? -1 : 1;
+    return lhs.w->compare(*rhs.w) < 0 ? -1 : (lhs.w->compare(*rhs.w) > 0 ? 1 : 0);
+  }
+
+  inline RangeWideInt& RangeWideInt::operator+= (const RangeWideInt& r) {
+    const boost::int64_t top = std::numeric_limits<boost::int64_t>::max();
+    const boost::int64_t bottom = std::numeric_limits<boost::int64_t>::min();
+    if(!w && !r.w && !(r.v > 0 && v > top - r.v) && !(r.v < 0 && v < bottom - r.v))
+      v += r.v;
+    else
+      assign(wide() + r.wide());
+    return *this;
+  }
+
+  inline RangeWideInt& RangeWideInt::operator-= (const RangeWideInt& r) {
+    const boost::int64_t top = std::numeric_limits<boost::int64_t>::max();
+    const boost::int64_t bottom = std::numeric_limits<boost::int64_t>::min();
+    if(!w && !r.w && !(r.v < 0 && v > top + r.v) && !(r.v > 0 && v < bottom + r.v))
+      v -= r.v;
+    else
+      assign(wide() - r.wide());
+    return *this;
+  }
+
+  // the product of two halves never overflows
+  inline RangeWideInt& RangeWideInt::operator*= (const RangeWideInt& r) {
+    const boost::int64_t half = boost::int64_t(1) << 31;
+    if(!w && !r.w && v < half && -half < v && r.v < half && -half < r.v)
+      v *= r.v;
+    else
+      assign(wide() * r.wide());
+    return *this;
+  }
+
+  // the only overflowing division is the lowest value by -1
+  inline RangeWideInt& RangeWideInt::operator/= (const RangeWideInt& r) {
+    if(!w && !r.w && !(r.v == -1 && v == std::numeric_limits<boost::int64_t>::min()))
+      v /= r.v;
+    else
+      assign(wide() / r.wide());
+    return *this;
+  }
+
+  inline RangeWideInt& RangeWideInt::operator%= (const RangeWideInt& r) {
+    if(!w && !r.w && r.v != -1)
+      v %= r.v;
+    else
+      assign(wide() % r.wide());
+    return *this;
+  }
+
+  inline RangeWideInt RangeWideInt::operator- () const {
+    RangeWideInt rv;
+    rv -= *this;
+    return rv;
+  }
+
+  //////////////////////////////////////////////
+  // Private Helpers
+
+  inline void RangeWideInt::assign(const wide_type& n) {
+    if(n >= std::numeric_limits<boost::int64_t>::min() &&
+       n <= std::numeric_limits<boost::int64_t>::max()) {
+      v = n.convert_to<boost::int64_t>();
+      delete w;
+      w = NULL;
+    } else if(w) {
+      *w = n;
+    } else {
+      w = new wide_type(n);
+    }
+  }
+
+  /////////////////////////////////////////////
+  // overload operators
+
+  inline RangeWideInt operator+ (RangeWideInt lhs, const RangeWideInt& rhs) { return lhs += rhs; }
+  inline RangeWideInt operator- (RangeWideInt lhs, const RangeWideInt& rhs) { return lhs -= rhs; }
+  inline RangeWideInt operator* (RangeWideInt lhs, const RangeWideInt& rhs) { return lhs *= rhs; }
+  inline RangeWideInt operator/ (RangeWideInt lhs, const RangeWideInt& rhs) { return lhs /= rhs; }
+  inline RangeWideInt operator% (RangeWideInt lhs, const RangeWideInt& rhs) { return lhs %= rhs; }
+
+  inline bool operator== (const RangeWideInt& lhs, const RangeWideInt& rhs) {
+    return RangeWideInt::compare(lhs, rhs) == 0;
+  }
+
+  inline bool operator!= (const RangeWideInt& lhs, const RangeWideInt& rhs) {
+    return RangeWideInt::compare(lhs, rhs) != 0;
+  }
+
+  inline bool operator< (const RangeWideInt& lhs, const RangeWideInt& rhs) {
+    return RangeWideInt::compare(lhs, rhs) < 0;
+  }
+
+  inline bool operator> (const RangeWideInt& lhs, const RangeWideInt& rhs) {
+    return RangeWideInt::compare(lhs, rhs) > 0;
+  }
+
+  inline bool operator<= (const RangeWideInt& lhs, const RangeWideInt& rhs) {
+    return RangeWideInt::compare(lhs, rhs) <= 0;
+  }
+
+  inline bool operator>= (const RangeWideInt& lhs, const RangeWideInt& rhs) {
+    return RangeWideInt::compare(lhs, rhs) >= 0;
+  }
+
+  inline std::ostream& operator<< (std::ostream& os, const RangeWideInt& r) {
+    if(r.inline_value()) os << static_cast<boost::int64_t>(r);
+    else                 os << r.wide();
+    return os;
+  }
+
+  inline std::istream& operator>> (std::istream& is, RangeWideInt& r) {
+    RangeWideInt::wide_type n;
+    if(is >> n) r = RangeWideInt(n);
+    return is;
+  }
+
+  // equal values have the same representation
+  inline std::size_t hash_value(const RangeWideInt& r) {
+    if(r.inline_value()) return boost::hash<boost::int64_t>()(static_cast<boost::int64_t>(r));
+    return boost::multiprecision::hash_value(r.wide());
+  }
+
+}
+
+namespace std {
+
+  inline CppRange::RangeWideInt numeric_limits<CppRange::RangeWideInt>::min() {
+    return CppRange::RangeWideInt();
+  }
+
+  inline CppRange::RangeWideInt numeric_limits<CppRange::RangeWideInt>::max() {
+    return CppRange::RangeWideInt();
+  }
+
+  inline CppRange::RangeWideInt numeric_limits<CppRange::RangeWideInt>::lowest() {
+    return CppRange::RangeWideInt();
+  }
+
+}
+
+#endif
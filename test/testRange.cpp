@@ -892,7 +892,7 @@ int main() {
   // overlap
   cout << ++index << ". RA overlaps with [3:0][15:12] ?";
   Range<int> m(RA); 
-  std::vector<RangeElement<int> >::iterator it = m.begin();
+  Range<int>::iterator it = m.begin();
   it++;
   *it = RangeElement<int>(15,12);
   if(!test(toString(RA.overlap(m)), "1", false, cout)) return 1;
@@ -1036,6 +1036,68 @@ int main() {
   if(!test(toString(RE.dimension()), "2", false, cout,
            "\n  *dimension() is not guarded by valid(), so even an invalid range can have a non-zero diemsnion number.")) return 1;
 
+  cout << ++index << ". construct and print a range with more dimensions than stored inline =>";
+  Range<int> RG;
+  for(int i=0; i<6; i++)
+    RG.add_lower(RangeElement<int>(i+1, 0));
+  Range<int> RG_copy(RG);
+  RG_copy.add_upper(RangeElement<int>(0));
+  RG_copy.remove_upper();
+  if(!test(toString(RG_copy), "[1:0][2:0][3:0][4:0][5:0][6:0]", false, cout)) return 1;
+
+  cout << ++index << ". the size of RG ?";
+  if(!test(toString(RG_copy.size()), "5040", false, cout)) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test fixed-dimension range ... " << endl;
+
+  cout << ++index << ". construct and print a fixed range FA [3:0][12:-5] =>";
+  FixedRange<int, 2> FA(RA);
+  if(!test(toString(FA), "[3:0][12:-5]", false, cout)) return 1;
+
+  cout << ++index << ". construct and print a fixed range FB [3:0][12:-3] =>";
+  FixedRange<int, 2> FB("[3:0][12:-3]");
+  if(!test(toString(FB), "[3:0][12:-3]", false, cout)) return 1;
+
+  cout << ++index << ". FB is a proper subset of FA ?";
+  if(!test(toString(FB.proper_subset(FA)), "1", false, cout)) return 1;
+
+  cout << ++index << ". FA < FB ?";
+  if(!test(toString(FA < FB), toString(RA < Range<int>("[3:0][12:-3]")), false, cout)) return 1;
+
+  cout << ++index << ". FA deducted by FB =>";
+  if(!test(toString(FA.complement(FB)), "[3:0][-4:-5]", false, cout)) return 1;
+
+  cout << ++index << ". FA divided by FB =>";
+  if(!test(toString(FA.divide(FB)), "[];[3:0][12:-3];[3:0][-4:-5]", false, cout)) return 1;
+
+  cout << ++index << ". FA & [2][0:-10] =>";
+  if(!test(toString(FA & FixedRange<int, 2>("[2][0:-10]")), "[2][0:-5]", false, cout)) return 1;
+
+  cout << ++index << ". the size of FA ?";
+  if(!test(toString(FA.size()), toString(RA.size()), false, cout)) return 1;
+
+  cout << ++index << ". convert FA back to a Range =>";
+  if(!test(toString(FA.toRange() == RA), "1", false, cout)) return 1;
+
+  cout << ++index << ". a default fixed range is empty ?";
+  if(!test(toString(FixedRange<int, 3>().empty()), "1", false, cout)) return 1;
+
+  cout << ++index << ". construct a fixed range from a range with different dimensions =>";
+#ifndef CPP_RANGE_NO_EXCEPTION
+  try {
+    result = toString(FixedRange<int, 3>(RA));
+  } catch ( RangeException_InvalidRange e) {
+    cout << "\n" << e.what() << endl;
+    result = "[]";
+  }
+#else
+  result = toString(FixedRange<int, 3>(RA));
+#endif
+  if(!test(result, "[]", false, cout,
+           "\n  *a FixedRange<T,3> needs exactly 3 dimensions.")) return 1;
+
 
   cout << "\nRange<int> test successful!" << endl;
   cout << endl;
@@ -105,6 +105,15 @@ int main() {
   cout << ++index << ". the size of RC ?";
   if(!test(toString(RD.size()), "0", false, cout)) return 1;
 
+  cout << ++index << ". set the upper bound of an empty range RD [3:0] =>";
+  RangeElement<int> RD_set;
+  RD_set.upper(3);
+  if(!test(toString(RD_set), "[3:0]", false, cout,
+           "\n  *the other bound of an empty range is reset to 0.")) return 1;
+
+  cout << ++index << ". a range element only stores its two bounds ?";
+  if(!test(toString(sizeof(RangeElement<int>) == 2*sizeof(int)), "1", false, cout)) return 1;
+
   cout << ++index << ". construct and print an invalid integer range RE [-2:0] =>";
   RangeElement<int> RE(-2,0);
   if(!test(toString(RE), "[]", false, cout)) return 1;
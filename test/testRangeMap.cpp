@@ -25,7 +25,17 @@
  */
 
 #include <iostream>
+#include <cstring>
+#include <set>
+#if __cplusplus >= 201103L
+#include <unordered_set>
+#include <thread>
+#endif
+#include <boost/random/mersenne_twister.hpp>
 #include "cpp_range.hpp"
+#if __cplusplus >= 201103L
+#include "cpp_range_wide.hpp"
+#endif
 #include "test_util.hpp"
 
 using namespace CppRange;
@@ -606,6 +616,726 @@ int main() {
   if(!test(toString(RE.dimension()), "2", false, cout,
            "\n  *dimension() is not guarded by valid(), so even an invalid range can have a non-zero diemsnion number.")) return 1;
 
+  // hull
+  cout << ++index << ". the hull of RA deducted by RC =>";
+  if(!test(toString(RA.complement(RC).hull()), "[3:0][12:-5]", false, cout)) return 1;
+
+  cout << ++index << ". the hull of {[3][4];[1][6:5]} =>";
+  if(!test(toString(RangeMap<int>("[3][4]").combine(RangeMap<int>("[1][6:5]")).hull()), "[3:1][6:4]", false, cout)) return 1;
+
+  cout << ++index << ". RA deducted by RC overlaps with RC ?";
+  if(!test(toString(RA.complement(RC).overlap(RC)), "0", false, cout)) return 1;
+
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test snapshots ... " << endl;
+
+  RangeMap<int> RG = RA.complement(RC);
+  RangeMapSnapshot<int> PG(RG);
+  cout << ++index << ". take a snapshot of RA deducted by RC =>";
+  if(!test(toString(PG), toString(RG), false, cout)) return 1;
+
+  cout << ++index << ". the number of nodes in the snapshot ?";
+  if(!test(toString(PG.node_count()), "7", false, cout)) return 1;
+
+  cout << ++index << ". the number of dimensions of the snapshot ?";
+  if(!test(toString(PG.dimension()), "2", false, cout)) return 1;
+
+  cout << ++index << ". the size of the snapshot ?";
+  if(!test(toString(PG.size()), toString(RG.size()), false, cout)) return 1;
+
+  cout << ++index << ". restore the snapshot from a copied node array =>";
+  std::vector<RangeMapSnapshot<int>::Node> PG_snapshot(PG.node_count());
+  std::memcpy(&PG_snapshot[0], PG.data(), PG.node_count() * sizeof(RangeMapSnapshot<int>::Node));
+  RangeMapSnapshot<int> PG_restore(&PG_snapshot[0], PG_snapshot.size());
+  if(!test(toString(PG_restore.toRangeMap()), toString(RG), false, cout)) return 1;
+
+  cout << ++index << ". the restored snapshot is equal to the original ?";
+  if(!test(toString(PG_restore == PG), "1", false, cout)) return 1;
+
+  cout << ++index << ". take a snapshot of an empty range =>";
+  if(!test(toString(RangeMapSnapshot<int>(RangeMap<int>())), "[]", false, cout)) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test point membership ... " << endl;
+
+  vector<int> RG_point;
+  RG_point.push_back(3); RG_point.push_back(-4);
+  Range<int> RG_box;
+  cout << ++index << ". [3][-4] belongs to RA deducted by RC ?";
+  if(!test(toString(RG.contains(RG_point, RG_box)), "1", false, cout)) return 1;
+
+  cout << ++index << ". the largest range vector holding [3][-4] =>";
+  if(!test(toString(RG_box), "[3][12:-5]", false, cout)) return 1;
+
+  RG_point[0] = 2;
+  cout << ++index << ". [2][-4] belongs to RA deducted by RC ?";
+  if(!test(toString(RG.contains(RG_point)), "0", false, cout)) return 1;
+
+  RG_point[1] = -5;
+  cout << ++index << ". the largest range vector holding [2][-5] =>";
+  RG.contains(&RG_point[0], RG_box);
+  if(!test(toString(RG_box), "[2][-5]", false, cout)) return 1;
+
+  RG_point.push_back(0);
+  cout << ++index << ". [2][-5][0] belongs to RA deducted by RC ?";
+#ifndef CPP_RANGE_NO_EXCEPTION
+  try {
+    result = toString(RG.contains(RG_point));
+  } catch ( RangeException_NonComparable e) {
+    cout << "\n" << e.what() << endl;
+    result = "0";
+  }
+#else
+  result = toString(RG.contains(RG_point));
+#endif
+  if(!test(result, "0", false, cout,
+           "\n  *not comparable due to different numbers of dimensions.")) return 1;
+
+  cout << ++index << ". [2][-5][0] belongs to an empty range ?";
+  if(!test(toString(RangeMap<int>().contains(RG_point)), "0", false, cout)) return 1;
+
+  int RG_batch[] = {3, -4, 2, -4, 2, -5, 4, 0, 0, 12, 0, 13};
+  vector<bool> RG_result = RG.contains(RG_batch, 6);
+  cout << ++index << ". [3][-4], [2][-4], [2][-5], [4][0], [0][12], [0][13] belong to RA deducted by RC ?";
+  result.clear();
+  for(unsigned int i=0; i<RG_result.size(); i++) result += toString(RG_result[i]);
+  if(!test(result, "101010", false, cout)) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test window query ... " << endl;
+
+  cout << ++index << ". RA deducted by RC clipped to [2:1][0:-5] =>";
+  result.clear();
+  for(RangeMap<int>::const_iterator it = RG.query(Range<int>("[2:1][0:-5]")); it != RG.end(); ++it)
+    result += toString(*it) + ";";
+  if(!test(result, "[2][0:-3];[2][-5];[1][0:-5];", false, cout)) return 1;
+
+  cout << ++index << ". iterate all range vectors of RA deducted by RC =>";
+  result.clear();
+  for(RangeMap<int>::const_iterator it = RG.begin(); it != RG.end(); it++)
+    result += toString(*it) + ";";
+  if(!test(result, "[3][12:-5];[2][12:-3];[2][-5];[1:0][12:-5];", false, cout)) return 1;
+
+  cout << ++index << ". convert RA deducted by RC to a list of ranges, the number of ranges ?";
+  if(!test(toString(RG.toRange().size()), "4", false, cout)) return 1;
+
+  cout << ++index << ". the first 3 points of RA deducted by RC =>";
+  RangeMap<int>::point_iterator RG_pit = RG.point_begin();
+  result = point_string(*RG_pit++);
+  result += point_string(*RG_pit++);
+  result += point_string(*RG_pit);
+  if(!test(result, "[0][-5][0][-4][0][-3]", false, cout)) return 1;
+
+  cout << ++index << ". the runs of the last dimension in RA deducted by RC =>";
+  result.clear();
+  for(RG_pit = RG.point_begin(); RG_pit != RG.point_end(); RG_pit.next_run())
+    result += toString(RG_pit->front()) + RangeElement<int>(RG_pit.run_upper(), RG_pit.run_lower()).toString() + ";";
+  if(!test(result, "0[12:-5];1[12:-5];2[-5];2[12:-3];3[12:-5];", false, cout)) return 1;
+
+  cout << ++index << ". the number of points in RA deducted by RC ?";
+  unsigned int RG_count = 0;
+  for(RG_pit = RG.point_begin(); RG_pit != RG.point_end(); ++RG_pit) RG_count++;
+  if(!test(toString(RG_count), "71", false, cout)) return 1;
+
+  cout << ++index << ". RA deducted by RC clipped to [2][-4] =>";
+  if(!test(toString(RG.query(Range<int>("[2][-4]")) == RG.end()), "1", false, cout)) return 1;
+
+  cout << ++index << ". RA deducted by RC clipped to [2] =>";
+#ifndef CPP_RANGE_NO_EXCEPTION
+  try {
+    result = toString(RG.query(Range<int>("[2]")) == RG.end());
+  } catch ( RangeException_NonComparable e) {
+    cout << "\n" << e.what() << endl;
+    result = "1";
+  }
+#else
+  result = toString(RG.query(Range<int>("[2]")) == RG.end());
+#endif
+  if(!test(result, "1", false, cout,
+           "\n  *not comparable due to different numbers of dimensions.")) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test operation cache ... " << endl;
+
+  {
+    RangeMapCache<int> cache;
+    RangeMap<int> RG_first = RA.complement(RC);
+    RangeMap<int> RG_second = RA.complement(RC);
+    cout << ++index << ". repeat RA deducted by RC with a cache =>";
+    if(!test(toString(RG_second), toString(RG), false, cout)) return 1;
+
+    cout << ++index << ". the number of cache hits and misses ?";
+    if(!test(toString(cache.hits()) + " " + toString(cache.misses()), "1 1", false, cout)) return 1;
+  }
+
+  cout << ++index << ". is a cache still active ?";
+  if(!test(toString(RangeMapCache<int>::active() != NULL), "0", false, cout)) return 1;
+
+  RangeMapCache<int>* RG_outer = new RangeMapCache<int>();
+  RangeMapCache<int>* RG_inner = new RangeMapCache<int>();
+  delete RG_outer;
+  cout << ++index << ". is the inner cache active after the outer cache is destroyed ?";
+  if(!test(toString(RangeMapCache<int>::active() == RG_inner), "1", false, cout)) return 1;
+
+  delete RG_inner;
+  cout << ++index << ". is a cache still active after both are destroyed ?";
+  if(!test(toString(RangeMapCache<int>::active() != NULL), "0", false, cout,
+           "\n  *caches may be destroyed out of order.")) return 1;
+
+#if __cplusplus >= 201103L
+  {
+    RangeMapCache<int> cache;
+    bool RG_other = true;
+    std::thread RG_thread([&RG_other]() { RG_other = RangeMapCache<int>::active() != NULL; });
+    RG_thread.join();
+    cout << ++index << ". is a cache of this thread active in another thread ?";
+    if(!test(toString(RG_other), "0", false, cout,
+             "\n  *every thread has its own active cache.")) return 1;
+  }
+#endif
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test free box search ... " << endl;
+
+  RangeMap<int> RH("[10:6]");
+  RH = RH.combine(RangeMap<int>(15));
+  cout << ++index << ". the first free [4] in [31:0] avoiding {[15];[10:6]} =>";
+  if(!test(toString(RH.find_free(vector<int>(1, 4), Range<int>("[31:0]"))), "[3:0]", false, cout)) return 1;
+
+  cout << ++index << ". the best free [4] in [31:0] avoiding {[15];[10:6]} =>";
+  if(!test(toString(RH.find_free(vector<int>(1, 4), Range<int>("[31:0]"), RangeMap<int>::best_fit)),
+           "[14:11]", false, cout)) return 1;
+
+  cout << ++index << ". the first free [1][1] in [3:0][12:-5] avoiding RA deducted by RC =>";
+  if(!test(toString(RG.find_free(vector<int>(2, 1), Range<int>("[3:0][12:-5]"))), "[2][-4]", false, cout)) return 1;
+
+  vector<int> RG_extent(2, 1);
+  RG_extent[1] = 2;
+  cout << ++index << ". the first free [1][2] in [3:0][12:-5] avoiding RA deducted by RC =>";
+  if(!test(toString(RG.find_free(RG_extent, Range<int>("[3:0][12:-5]"))), "[]", false, cout)) return 1;
+
+  RangeMap<int> RH_limit = RangeMap<int>("[2147483647:2147483644]") | RangeMap<int>(0)
+    | RangeMap<int>("[-2147483645:-2147483648]");
+  cout << ++index << ". the first free [4] in [*] avoiding " << RH_limit << " =>";
+  if(!test(toString(RH_limit.find_free(vector<int>(1, 4), Range<int>("[*]"))),
+           "[-2147483641:-2147483644]", false, cout)) return 1;
+
+  cout << ++index << ". the best free [4] in [*] avoiding " << RH_limit << " =>";
+  if(!test(toString(RH_limit.find_free(vector<int>(1, 4), Range<int>("[*]"), RangeMap<int>::best_fit)),
+           "[4:1]", false, cout,
+           "\n  *gaps reaching the limits are counted without overflow.")) return 1;
+
+  cout << ++index << ". the first free [2147483647] in [*] avoiding " << RH_limit << " =>";
+  if(!test(toString(RH_limit.find_free(vector<int>(1, 2147483647), Range<int>("[*]"))), "[]", false, cout)) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test fragmented leaf ranges ... " << endl;
+
+  RangeMap<int> RI;
+  for(int i=-4; i<12; i+=2) RI = RI.combine(RangeMap<int>(i));
+  cout << ++index << ". even numbers in [11:-4] =>";
+  if(!test(toString(RI), "{[10];[8];[6];[4];[2];[0];[-2];[-4]}", false, cout)) return 1;
+
+  cout << ++index << ". {[10];...;[-4]} | [7:-1] =>";
+  if(!test(toString(RI | RangeMap<int>(7, -1)), "{[10];[8:-2];[-4]}", false, cout)) return 1;
+
+  cout << ++index << ". {[10];...;[-4]} & [7:-1] =>";
+  if(!test(toString(RI & RangeMap<int>(7, -1)), "{[6];[4];[2];[0]}", false, cout)) return 1;
+
+  cout << ++index << ". [7:-1] deducted by {[10];...;[-4]} =>";
+  if(!test(toString(RangeMap<int>(7, -1).complement(RI)), "{[7];[5];[3];[1];[-1]}", false, cout)) return 1;
+
+  cout << ++index << ". {[6];[4];[2];[0]} is a subset of {[10];...;[-4]} ?";
+  if(!test(toString((RI & RangeMap<int>(7, -1)).subset(RI)), "1", false, cout)) return 1;
+
+  RangeMap<int> RJ;
+  for(int i=-4; i<12; i+=2) RJ = RJ.combine(RangeMap<int>("[3][" + toString(i) + "]"));
+  cout << ++index << ". [3][12:-4] deducted by [3]{[10];...;[-4]} =>";
+  if(!test(toString(RangeMap<int>("[3][12:-4]").complement(RJ)),
+           "[3]{[12:11];[9];[7];[5];[3];[1];[-1];[-3]}", false, cout)) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test flat one dimensional set ... " << endl;
+
+  RangeSet<int> SA(7, 4);
+  SA.add(RangeElement<int>(1, -2));
+  SA.add(RangeElement<int>(12));
+  cout << ++index << ". build SA {[12];[7:4];[1:-2]} =>";
+  if(!test(toString(SA), "{[12];[7:4];[1:-2]}", false, cout)) return 1;
+
+  cout << ++index << ". add [3:2] to SA in place =>";
+  SA.add(RangeElement<int>(3, 2));
+  if(!test(toString(SA), "{[12];[7:-2]}", false, cout)) return 1;
+
+  cout << ++index << ". remove [5:0] from SA in place =>";
+  SA.remove(RangeElement<int>(5, 0));
+  if(!test(toString(SA), "{[12];[7:6];[-1:-2]}", false, cout)) return 1;
+
+  cout << ++index << ". does SA contain 6, 5 and -2 ?";
+  if(!test(toString(SA.contains(6)) + toString(SA.contains(5)) + toString(SA.contains(-2)),
+           "101", false, cout)) return 1;
+
+  cout << ++index << ". the size of SA ?";
+  if(!test(toString(SA.size()), "5", false, cout)) return 1;
+
+  cout << ++index << ". SA | [10:7] =>";
+  if(!test(toString(SA | RangeSet<int>(10, 7)), "{[12];[10:6];[-1:-2]}", false, cout)) return 1;
+
+  cout << ++index << ". SA & [12:-1] =>";
+  if(!test(toString(SA & RangeSet<int>(12, -1)), "{[12];[7:6];[-1]}", false, cout)) return 1;
+
+  cout << ++index << ". [12:-2] deducted by SA =>";
+  if(!test(toString(RangeSet<int>(12, -2).complement(SA)), "{[11:8];[5:0]}", false, cout)) return 1;
+
+  cout << ++index << ". SA as a RangeMap is equal to the same RangeMap ?";
+  if(!test(toString(RangeMap<int>(SA) == (RangeMap<int>(12) | RangeMap<int>(7, 6) | RangeMap<int>(-1, -2))),
+           "1", false, cout)) return 1;
+
+  const int int_max = std::numeric_limits<int>::max(), int_min = std::numeric_limits<int>::min();
+  cout << ++index << ". [" << int_max << ":4] | [" << int_max << ":-5] =>";
+  if(!test(toString(RangeMap<int>(int_max, 4) | RangeMap<int>(int_max, -5)), "[2147483647:-5]", false, cout,
+           "\n  *ranges reaching the largest value are merged without stepping past it.")) return 1;
+
+  cout << ++index << ". [-5:" << int_min << "] | [" << int_min << "] =>";
+  if(!test(toString(RangeMap<int>(-5, int_min) | RangeMap<int>(int_min)), "[-5:-2147483648]", false, cout)) return 1;
+
+  RangeSet<int> SD(int_max, 10);
+  SD.add(RangeElement<int>(int_max, 0));
+  cout << ++index << ". add [" << int_max << ":0] to [" << int_max << ":10] in place =>";
+  if(!test(toString(SD), "[2147483647:0]", false, cout)) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test dense bitmask conversion ... " << endl;
+
+  RangeMap<int> RK = RangeMap<int>("[1][3:2]") | RangeMap<int>("[0][1:0]");
+  Range<int> RK_universe("[1:0][3:0]");
+  cout << ++index << ". export {[1][3:2];[0][1:0]} over [1:0][3:0] =>";
+  if(!test(toString(RK.toBitmask(RK_universe)[0]), "195", false, cout)) return 1;
+
+  cout << ++index << ". import 195 over [1:0][3:0] =>";
+  if(!test(toString(RangeMap<int>(RK_universe, RK.toBitmask(RK_universe))), toString(RK), false, cout)) return 1;
+
+  cout << ++index << ". import 0xf0 over [1:0][3:0] =>";
+  if(!test(toString(RangeMap<int>(RK_universe, vector<boost::uint64_t>(1, 0xf0))), "[1][3:0]", false, cout)) return 1;
+
+  cout << ++index << ". export [5:0] over the universe [3:2] =>";
+  if(!test(toString(RangeMap<int>(5, 0).toBitmask(Range<int>("[3:2]"))[0]), "3", false, cout,
+           "\n  *points out of the universe are dropped.")) return 1;
+
+  cout << ++index << ". export {[1][3:2];[0][1:0]} over [3:0] =>";
+#ifndef CPP_RANGE_NO_EXCEPTION
+  try {
+    result = toString(RK.toBitmask(Range<int>("[3:0]")).size());
+  } catch ( RangeException_NonComparable e) {
+    result = "0";
+  }
+#else
+  result = toString(RK.toBitmask(Range<int>("[3:0]")).size());
+#endif
+  if(!test(result, "0", false, cout,
+           "\n  *the universe must have the same number of dimensions.")) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test row-major offsets ... " << endl;
+
+  cout << ++index << ". the offsets of {[1][3:2];[0][1:0]} in [1:0][3:0] =>";
+  if(!test(toString(RK.flatten(RK_universe)), "{[7:6];[1:0]}", false, cout)) return 1;
+
+  RangeMap<int> RL = RangeMap<int>("[1][1:0]") | RangeMap<int>("[0][3:2]");
+  cout << ++index << ". the offsets of {[1][1:0];[0][3:2]} in [1:0][3:0] =>";
+  if(!test(toString(RL.flatten(RK_universe)), "[5:2]", false, cout,
+           "\n  *contiguous offsets of neighbouring rows are merged.")) return 1;
+
+  cout << ++index << ". the points of the offsets [5:2] in [1:0][3:0] =>";
+  if(!test(toString(RangeMap<int>(RK_universe, RangeSet<int>(5, 2))), toString(RL), false, cout)) return 1;
+
+  cout << ++index << ". the points of the offsets [9:-1] in [1:0][3:0] =>";
+  if(!test(toString(RangeMap<int>(RK_universe, RangeSet<int>(9, -1))), "[1:0][3:0]", false, cout,
+           "\n  *offsets out of the universe are dropped.")) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test coordinate compression ... " << endl;
+
+  RangeMap<int> RM = RangeMap<int>("[1000000:999990][5000:10]") | RangeMap<int>("[20:0][70000:4000]");
+  RangeMap<int> RN("[999995:10][6000:5000]");
+  RangeMapCompressor<int> RM_comp;
+  RM_comp.add(RM);
+  RM_comp.add(RN);
+
+  cout << ++index << ". the number of elementary ranges of RM and RN in each dimension =>";
+  if(!test(toString(RM_comp.size(0)) + "," + toString(RM_comp.size(1)), "6,6", false, cout)) return 1;
+
+  cout << ++index << ". compress " << RM << " =>";
+  if(!test(toString(RM_comp.compress(RM)), "{[4:3][2:0];[1:0][4:1]}", false, cout)) return 1;
+
+  cout << ++index << ". combine RM and RN in the compressed space =>";
+  if(!test(toString(RM_comp.combine(RM, RN)), toString(RM | RN), false, cout)) return 1;
+
+  cout << ++index << ". RM deducted by RN in the compressed space =>";
+  if(!test(toString(RM_comp.complement(RM, RN)), toString(RM.complement(RN)), false, cout)) return 1;
+
+  cout << ++index << ". expand the compressed RM =>";
+  if(!test(toString(RM_comp.expand(RM_comp.compress(RM))), toString(RM), false, cout)) return 1;
+
+  cout << ++index << ". compress [7][7] =>";
+#ifndef CPP_RANGE_NO_EXCEPTION
+  try {
+    result = toString(RM_comp.compress(RangeMap<int>("[7][7]")));
+  } catch ( RangeException_InvalidRange e) {
+    result = "[]";
+  }
+#else
+  result = toString(RM_comp.compress(RangeMap<int>("[7][7]")));
+#endif
+  if(!test(result, "[]", false, cout,
+           "\n  *the bounds of a compressed map must be added beforehand.")) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test wildcard dimensions ... " << endl;
+
+  RangeMap<int> RO("[3][*][5:0]");
+  RangeMap<int> RP("[4:2][7:0][9:2]");
+  cout << ++index << ". " << RO << " & " << RP << " =>";
+  if(!test(toString(RO & RP), "[3][7:0][5:2]", false, cout)) return 1;
+
+  cout << ++index << ". " << RP << " - " << RO << " =>";
+  if(!test(toString(RP.complement(RO)), "{[4][7:0][9:2];[3][7:0][9:6];[2][7:0][9:2]}", false, cout)) return 1;
+
+  RangeMap<int> RQ("[*][*]");
+  cout << ++index << ". " << RQ << " | [5:0][2] =>";
+  if(!test(toString(RQ | RangeMap<int>("[5:0][2]")), "[*][*]", false, cout,
+           "\n  *a universal map absorbs a union without visiting the other map.")) return 1;
+
+  cout << ++index << ". (" << RQ << " - [5:0][2]) | [5:0][2] =>";
+  if(!test(toString(RQ.complement(RangeMap<int>("[5:0][2]")) | RangeMap<int>("[5:0][2]")), "[*][*]", false, cout,
+           "\n  *ranges covering a whole dimension are merged back into a wildcard.")) return 1;
+
+  cout << ++index << ". " << RO << " is a subset of [3][*][*] ?";
+  if(!test(toString(RO.subset(RangeMap<int>("[3][*][*]"))), "1", false, cout)) return 1;
+
+  RangeMap<int> RW_top("[2147483647:5][7:4]");
+  cout << ++index << ". [*][3:0] | " << RW_top << " =>";
+  if(!test(toString(RangeMap<int>("[*][3:0]") | RW_top), "{[2147483647:5][7:0];[4:-2147483648][3:0]}", false, cout,
+           "\n  *a wildcard next to a range ending at the largest value.")) return 1;
+
+  cout << ++index << ". ([*][3:0] | " << RW_top << ") - " << RW_top << " =>";
+  if(!test(toString((RangeMap<int>("[*][3:0]") | RW_top).complement(RW_top)), "[*][3:0]", false, cout)) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test strided ranges ... " << endl;
+
+  RangeStride<int> SB("[1023:0:4]");
+  cout << ++index << ". the number of values in " << SB << " ?";
+  if(!test(toString(SB.size()), "256", false, cout)) return 1;
+
+  RangeStride<int> SC(1000, 2, 6);
+  cout << ++index << ". " << SB << " & " << SC << " =>";
+  if(!test(toString(SB & SC), "[992:8:12]", false, cout,
+           "\n  *the shared values repeat every lcm(4, 6).")) return 1;
+
+  cout << ++index << ". " << SB << " & [1001:3:6] =>";
+  if(!test(toString(SB & RangeStride<int>(1001, 3, 6)), "[]", false, cout,
+           "\n  *odd values never meet even values.")) return 1;
+
+  cout << ++index << ". [96:0:12] is a subset of " << SB << " ?";
+  if(!test(toString(RangeStride<int>(96, 0, 12).subset(SB)), "1", false, cout)) return 1;
+
+  cout << ++index << ". expand [12:0:4] =>";
+  if(!test(toString(RangeStride<int>(12, 0, 4).toSet()), "{[12];[8];[4];[0]}", false, cout)) return 1;
+
+  cout << ++index << ". the number of values in [2147483647:-2147483648:1] ?";
+  if(!test(toString(RangeStride<int>(int_max, int_min, 1).size()), "2147483647", false, cout,
+           "\n  *the size saturates at the largest value of T.")) return 1;
+
+  cout << ++index << ". [15:0:-4] is a valid stride ?";
+#ifndef CPP_RANGE_NO_EXCEPTION
+  try {
+    result = toString(RangeStride<int>("[15:0:-4]").valid());
+  } catch ( RangeException_InvalidRange e) {
+    cout << "\n" << e.what() << endl;
+    result = "0";
+  }
+#else
+  result = toString(RangeStride<int>("[15:0:-4]").valid());
+#endif
+  if(!test(result, "0", false, cout,
+           "\n  *the step is unsigned, a negative step is rejected.")) return 1;
+
+  RangeStride<unsigned long long> SW(18446744073709551233ULL, 3896582227470691027ULL, 7275080923119430103ULL);
+  RangeStride<unsigned long long> SX(18446744073709551233ULL, 1ULL, 18446744073709551232ULL);
+  cout << ++index << ". " << SW << " & " << SX << " =>";
+  if(!test(toString(SW & SX), "[18446744073709551233]", false, cout,
+           "\n  *steps above 2^63 are solved without overflow.")) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test wide bounds ... " << endl;
+
+  cout << ++index << ". the size of [2000000000:-2000000000] ?";
+  if(!test(toString(RangeElement<int>(2000000000, -2000000000).size()), "2147483647", false, cout,
+           "\n  *a size out of the type saturates at the largest value.")) return 1;
+
+  cout << ++index << ". the size of [*][*] ?";
+  if(!test(toString(RangeMap<int>("[*][*]").size()), "2147483647", false, cout)) return 1;
+
+  cout << ++index << ". the size of a snapshot of [*][*] ?";
+  if(!test(toString(RangeMapSnapshot<int>(RangeMap<int>("[*][*]")).size()), "2147483647", false, cout)) return 1;
+
+  cout << ++index << ". is [-2147483648:2147483647] valid ?";
+  if(!test(toString(RangeElement<int>(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()).valid()),
+           "0", false, cout,
+           "\n  *only a default constructed range is the empty marker.")) return 1;
+
+  cout << ++index << ". is RangeMap [-2147483648:2147483647] valid ?";
+  if(!test(toString(RangeMap<int>(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()).valid()),
+           "0", false, cout)) return 1;
+
+  cout << ++index << ". is a parsed [-2147483648:2147483647] valid ?";
+  if(!test(toString(RangeElement<int>("[-2147483648:2147483647]").valid()), "0", false, cout)) return 1;
+
+  RangeElement<int> RVE(5, std::numeric_limits<int>::max());
+  RVE.upper(std::numeric_limits<int>::min());
+  cout << ++index << ". is [5:2147483647] with the upper bound set to -2147483648 valid ?";
+  if(!test(toString(RVE.valid()), "0", false, cout)) return 1;
+
+#if __cplusplus >= 201103L
+  // Boost.Multiprecision needs C++11
+  RangeMap<RangeWideInt> RR("[100000000000000000000000:99999999999999999999990][3:0]");
+  RR = RR | RangeMap<RangeWideInt>("[7:-5][1]");
+  cout << ++index << ". the number of points in " << RR << " ?";
+  if(!test(toString(RR.size()), "57", false, cout)) return 1;
+
+  cout << ++index << ". the size of [100000000000000000000000:-5] ?";
+  if(!test(toString(RangeElement<RangeWideInt>("[100000000000000000000000:-5]").size()),
+           "100000000000000000000006", false, cout)) return 1;
+
+  RangeWideInt RW = RangeWideInt(RangeWideInt::wide_type("100000000000000000000000")) - RangeWideInt(3);
+  RW = RW - RangeWideInt(RangeWideInt::wide_type("99999999999999999999990"));
+  cout << ++index << ". the difference of two wide values is stored inline ?";
+  if(!test(toString(RW.inline_value()), "1", false, cout,
+           "\n  *a value fitting in 64 bits always moves back inline.")) return 1;
+
+  cout << ++index << ". is a wide [0:1] valid ?";
+  if(!test(toString(RangeElement<RangeWideInt>(RangeWideInt(0), RangeWideInt(1)).valid()), "0", false, cout)) return 1;
+
+  cout << ++index << ". is a wide RangeMap [0:1] valid ?";
+  if(!test(toString(RangeMap<RangeWideInt>("[0:1]").valid()), "0", false, cout)) return 1;
+#endif
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test dimension order ... " << endl;
+
+  RangeMap<int> RS("[40][3:0][7:4]");
+  RS = RS | RangeMap<int>("[20][3:0][7:4]") | RangeMap<int>("[0][3:0][7:4]");
+  cout << ++index << ". the number of nodes of " << RS << " ?";
+  if(!test(toString(RS.node_count()), "9", false, cout)) return 1;
+
+  std::vector<unsigned int> RS_order(3);
+  RS_order[0] = 1; RS_order[1] = 2; RS_order[2] = 0;
+  cout << ++index << ". move the first dimension of " << RS << " to the last =>";
+  if(!test(toString(RS.permute(RS_order)), "[3:0][7:4]{[40];[20];[0]}", false, cout)) return 1;
+
+  RangeMapView<int> RS_view(RS);
+  cout << ++index << ". the number of nodes of " << RS << " in its best order ?";
+  if(!test(toString(RS_view.node_count()), "5", false, cout,
+           "\n  *a dimension cut into many pieces is better placed last.")) return 1;
+
+  RS_order[0] = 1; RS_order[1] = 0; RS_order[2] = 2;
+  RangeMapView<int> RS_other(RangeMap<int>("[10][3:0][7:4]"), RS_order);
+  cout << ++index << ". " << RS_view << " | [10][3:0][7:4] =>";
+  if(!test(toString(RS_view | RS_other), "{[40][3:0][7:4];[20][3:0][7:4];[10][3:0][7:4];[0][3:0][7:4]}", false, cout,
+           "\n  *views in different orders are aligned before the union.")) return 1;
+
+  std::vector<int> RS_point;
+  RS_point.push_back(20); RS_point.push_back(2); RS_point.push_back(5);
+  cout << ++index << ". [20][2][5] belongs to " << RS_view << " ?";
+  if(!test(toString(RS_view.contains(RS_point)), "1", false, cout)) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test canonical order ... " << endl;
+
+  RangeMap<int> RT = RangeMap<int>("[5:3][3:0]") | RangeMap<int>("[2:0][3:0]");
+  RangeMap<int> RU = RangeMap<int>("[5:0][7:0]").complement(RangeMap<int>("[5:0][7:4]"));
+  cout << ++index << ". " << RT << " and " << RU << " have the same hash ?";
+  if(!test(toString(RT.hash() == RU.hash()), "1", false, cout,
+           "\n  *equal sets have the same normalized form.")) return 1;
+
+  cout << ++index << ". [3][1:0] < [3][2:0] ?";
+  if(!test(toString(RangeMap<int>("[3][1:0]") < RangeMap<int>("[3][2:0]")), "1", false, cout)) return 1;
+
+  RangeMap<int> RV = RangeMap<int>("[5:4][1]") | RangeMap<int>("[2][1]");
+  cout << ++index << ". [5:4][1] < " << RV << " ?";
+  if(!test(toString(RangeMap<int>("[5:4][1]") < RV), "1", false, cout,
+           "\n  *a list is lower than the longer lists it begins.")) return 1;
+
+  std::set<RangeMap<int> > RT_set;
+  RT_set.insert(RT); RT_set.insert(RU); RT_set.insert(RV);
+  RT_set.insert(RangeMap<int>("[2][1]") | RangeMap<int>("[5:4][1]"));
+  cout << ++index << ". the number of different maps in a set of " << RT << ", "
+       << RU << ", " << RV << " and " << RV << " ?";
+  if(!test(toString(RT_set.size()), "2", false, cout)) return 1;
+
+  Range<int> RT_high, RT_low;               // [3:0][] and [][3:0]
+  RT_high.add_lower(RangeElement<int>(3,0)); RT_high.add_lower(RangeElement<int>());
+  RT_low.add_lower(RangeElement<int>()); RT_low.add_lower(RangeElement<int>(3,0));
+  cout << ++index << ". [3:0][] == [][3:0] ?";
+  if(!test(toString(RangeMap<int>(RT_high) == RangeMap<int>(RT_low)), "1", false, cout,
+           "\n  *both are the empty set.")) return 1;
+
+  cout << ++index << ". [3:0][] < [][3:0] or [][3:0] < [3:0][] ?";
+  if(!test(toString(RangeMap<int>(RT_high) < RangeMap<int>(RT_low) ||
+                    RangeMap<int>(RT_low) < RangeMap<int>(RT_high)), "0", false, cout)) return 1;
+
+  cout << ++index << ". [1:3] == [1:3] reports an invalid range ?";
+#ifndef CPP_RANGE_NO_EXCEPTION
+  try {
+    RangeMap<int>(1,3).equal(RangeMap<int>(1,3));
+    result = "0";
+  } catch ( RangeException_InvalidRange e) {
+    cout << "\n" << e.what() << endl;
+    result = "1";
+  }
+#else
+  result = toString(!RangeMap<int>(1,3).equal(RangeMap<int>(1,3)));
+#endif
+  if(!test(result, "1", false, cout,
+           "\n  *invalid ranges are reported when the hashes match.")) return 1;
+
+#if __cplusplus >= 201103L
+  std::unordered_set<RangeMap<int> > RT_hash_set(RT_set.begin(), RT_set.end());
+  RT_hash_set.insert(RU); RT_hash_set.insert(RangeMap<int>(RT_high)); RT_hash_set.insert(RangeMap<int>(RT_low));
+  cout << ++index << ". the number of different maps in an unordered set of " << RT << ", "
+       << RU << ", " << RV << ", [3:0][] and [][3:0] ?";
+  if(!test(toString(RT_hash_set.size()), "3", false, cout)) return 1;
+#endif
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test rank and select ... " << endl;
+
+  RG_point.resize(2);
+  RG_point[0] = 2; RG_point[1] = -4;
+  cout << ++index << ". the number of points before [2][-4] in RA deducted by RC ?";
+  if(!test(toString(RG.rank(RG_point)), "37", false, cout)) return 1;
+
+  RG_point[1] = 20;
+  cout << ++index << ". the number of points before [2][20] in RA deducted by RC ?";
+  if(!test(toString(RG.rank(RG_point)), "53", false, cout)) return 1;
+
+  cout << ++index << ". the 37th point of RA deducted by RC (from 0) =>";
+  if(!test(point_string(RG.select(37)), "[2][-3]", false, cout)) return 1;
+
+  cout << ++index << ". the 70th point of RA deducted by RC (from 0) =>";
+  if(!test(point_string(RG.select(70)), "[3][12]", false, cout)) return 1;
+
+  cout << ++index << ". the 71st point of RA deducted by RC (from 0) =>";
+  if(!test(point_string(RG.select(71)), "", false, cout)) return 1;
+
+  RangeMap<int> RR_rank("[*][1:0]");
+  RG_point[0] = int_max; RG_point[1] = 0;
+  cout << ++index << ". the number of points before [2147483647][0] in " << RR_rank << " ?";
+  if(!test(toString(RR_rank.rank(RG_point)), "2147483647", false, cout,
+           "\n  *the rank saturates at the largest value of T.")) return 1;
+
+  RR_rank = RangeMap<int>("[*]");
+  RG_point.resize(1);
+  cout << ++index << ". the number of points before [2147483647] in " << RR_rank << " ?";
+  if(!test(toString(RR_rank.rank(RG_point)), "2147483647", false, cout)) return 1;
+
+  boost::random::mt19937 RG_rng(2014);
+  cout << ++index << ". draw a random point of RC =>";
+  if(!test(point_string(RC.sample(RG_rng)), "[2][-4]", false, cout)) return 1;
+
+  vector<int> RG_samples = RG.sample_n(RG_rng, 1000);
+  cout << ++index << ". draw 1000 random points of RA deducted by RC, all belong to it ?";
+  result = toString(RG_samples.size() == 2000);
+  for(unsigned int i=0; i<1000; i++)
+    if(!RG.contains(&RG_samples[2*i])) result = "0";
+  if(!test(result, "1", false, cout)) return 1;
+
+  RangeMap<int> RG_wide("[*][1:0]");
+  RG_samples = RG_wide.sample_n(RG_rng, 1000);
+  cout << ++index << ". draw 1000 random points of " << RG_wide << ", all belong to it ?";
+  result = toString(RG_samples.size() == 2000);
+  for(unsigned int i=0; i<1000; i++)
+    if(!RG_wide.contains(&RG_samples[2*i])) result = "0";
+  if(!test(result, "1", false, cout)) return 1;
+
+  unsigned int RG_negative = 0;
+  for(unsigned int i=0; i<1000; i++)
+    if(RG_samples[2*i] < 0) RG_negative++;
+  cout << ++index << ". between 400 and 600 of them have a negative first value ?";
+  if(!test(toString(RG_negative > 400 && RG_negative < 600), "1", false, cout,
+           "\n  *a saturated size is sampled level by level.")) return 1;
+
+  /////////////////////////////////////////////////////////////
+  cout << endl;
+  cout << "Test B+-tree top level ... " << endl;
+
+  RangeBTree<int> BT;
+  for(int i=0; i<3000; i++)
+    BT.insert(Range<int>(RangeElement<int>(2*(i*7%3000))));
+  cout << ++index << ". insert 3000 disjoint bits in random order, the number of top-level ranges ?";
+  if(!test(toString(BT.width()), "3000", false, cout)) return 1;
+
+  cout << ++index << ". the size of the B+-tree ?";
+  if(!test(toString(BT.size()), "3000", false, cout)) return 1;
+
+  cout << ++index << ". [2468] belongs to the B+-tree ?";
+  if(!test(toString(BT.contains(vector<int>(1, 2468))), "1", false, cout)) return 1;
+
+  cout << ++index << ". [2469] belongs to the B+-tree ?";
+  if(!test(toString(BT.contains(vector<int>(1, 2469))), "0", false, cout)) return 1;
+
+  for(int i=0; i<1499; i++)
+    BT.insert(Range<int>(RangeElement<int>(2*i+1)));
+  cout << ++index << ". fill the gaps below 2998, the number of top-level ranges ?";
+  if(!test(toString(BT.width()), "1501", false, cout)) return 1;
+
+  BT.remove(Range<int>(RangeElement<int>(5998, 3000)));
+  cout << ++index << ". remove [5998:3000] =>";
+  if(!test(toString(BT), "[2998:0]", false, cout)) return 1;
+
+  RangeBTree<int> BT2;
+  BT2.insert(RMap_builderC.hull(Range<int>("[3:0][12:-5]")));
+  BT2.remove(RMap_builderC);
+  cout << ++index << ". [3:0][12:-5] deducted by RC =>";
+  if(!test(toString(BT2), toString(RA.complement(RC)), false, cout)) return 1;
+
+  vector<int> BT2_point;
+  BT2_point.push_back(2); BT2_point.push_back(-4);
+  cout << ++index << ". [2][-4] belongs to it ?";
+  if(!test(toString(BT2.contains(BT2_point)), "0", false, cout)) return 1;
+
+  BT2_point[1] = -5;
+  cout << ++index << ". [2][-5] belongs to it ?";
+  if(!test(toString(BT2.contains(BT2_point)), "1", false, cout)) return 1;
+
+  RangeBTree<int> BT3;
+  BT3.insert(Range<int>(RangeElement<int>(int_max, 10)));
+  BT3.insert(Range<int>(RangeElement<int>(int_max, 0)));
+  BT3.insert(Range<int>(RangeElement<int>(-1, int_min)));
+  cout << ++index << ". insert [" << int_max << ":10], [" << int_max << ":0] and [-1:" << int_min << "] =>";
+  if(!test(toString(BT3), "[*]", false, cout,
+           "\n  *neighbours at both limits are merged without stepping past them.")) return 1;
+
+  cout << ++index << ". the size of the B+-tree ?";
+  if(!test(toString(BT3.size()), "2147483647", false, cout)) return 1;
 
   cout << "\nRangeMap<int> test successful!" << endl;
   cout << endl;